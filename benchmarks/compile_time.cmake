@@ -0,0 +1,24 @@
+# Compiles benchmarks/compile_time.cpp in header-only and in compiled-library mode, and writes the wall time of each to a JSON file.
+# Invoked by the argparse_bench_compile_time target with COMPILER, SOURCE, INCLUDE_DIR, FLAGS, OUTPUT and REPEATS defined.
+separate_arguments(FLAGS)
+set(results "")
+foreach(mode header_only compiled_library)
+    set(defines "")
+    if(mode STREQUAL "compiled_library")
+        set(defines -DARGPARSE_COMPILED_LIBRARY)
+    endif()
+    string(TIMESTAMP start "%s%f")
+    foreach(i RANGE 1 ${REPEATS})
+        execute_process(COMMAND ${COMPILER} ${FLAGS} ${defines} -I${INCLUDE_DIR} -c ${SOURCE} -o ${OUTPUT}.${mode}.o
+                RESULT_VARIABLE result)
+        if(NOT result EQUAL 0)
+            message(FATAL_ERROR "compiling ${SOURCE} in ${mode} mode failed")
+        endif()
+    endforeach()
+    string(TIMESTAMP end "%s%f")
+    math(EXPR ms "(${end} - ${start}) / (1000 * ${REPEATS})")
+    message(STATUS "argparse ${mode}: ${ms} ms per compile")
+    list(APPEND results "    \"${mode}_ms\": ${ms}")
+endforeach()
+list(JOIN results ",\n" results)
+file(WRITE ${OUTPUT} "{\n${results}\n}\n")
@@ -0,0 +1,18 @@
+/* @author: Morris Franken
+ * A typical translation unit using argparse, compiled by the `argparse_bench_compile_time` target to track the cost of including the header
+ */
+#include "argparse/argparse.hpp"
+
+struct Args : public argparse::Args {
+    std::string &src_path           = arg("a positional string argument");
+    int &k                          = kwarg("k", "A required integer value");
+    float &alpha                    = kwarg("a,alpha", "An optional float value").set_default(0.5f);
+    std::vector<int> &numbers       = kwarg("n,numbers", "An int vector, comma separated");
+    std::optional<std::string> &out = kwarg("o,output", "An optional string");
+    bool &verbose                   = flag("v,verbose", "A flag to toggle verbose");
+};
+
+int main(int argc, char *argv[]) {
+    auto args = argparse::parse<Args>(argc, argv);
+    return args.verbose? args.k : 0;
+}
@@ -0,0 +1,51 @@
+/* @author: Morris Franken
+ * Compares the key lookup of the frozen argparse::KeyIndex against the std::map that was previously used during parsing
+ */
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+
+#include "argparse/argparse.hpp"
+
+template <typename F> double ns_per_lookup(const std::vector<std::string> &queries, size_t repeats, F &&lookup) {
+    size_t found = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repeats; r++) {
+        for (const std::string &q : queries)
+            found += lookup(std::string_view(q)) != nullptr;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    if (found != queries.size() * repeats)
+        std::cerr << "lookup failed" << std::endl;
+    return std::chrono::duration<double, std::nano>(end - start).count() / double(queries.size() * repeats);
+}
+
+int main() {
+    std::mt19937 rng(42);
+    std::cout << "keys, std::map (ns/lookup), KeyIndex (ns/lookup)" << std::endl;
+    for (const size_t n_keys : {10, 100, 500, 2000}) {
+        std::map<std::string, int, std::less<>> entries;
+        for (size_t i = 0; i < n_keys; i++)
+            entries["option-name-" + std::to_string(i)] = int(i);
+        for (char c = 'a'; c <= 'z'; c++)
+            entries[std::string(1, c)] = c;
+
+        argparse::KeyIndex<int> index;
+        index.build(entries);
+
+        std::vector<std::string> queries;
+        for (size_t i = 0; i < 100000; i++) {
+            auto it = std::next(entries.begin(), rng() % entries.size());
+            queries.emplace_back(it->first);
+        }
+
+        const double t_map = ns_per_lookup(queries, 10, [&](std::string_view key) -> const int* {
+            auto it = entries.find(key);
+            return it != entries.end()? &it->second : nullptr;
+        });
+        const double t_index = ns_per_lookup(queries, 10, [&](std::string_view key) { return index.find(key); });
+        std::cout << n_keys << ", " << t_map << ", " << t_index << std::endl;
+    }
+    return 0;
+}
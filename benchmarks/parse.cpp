@@ -0,0 +1,202 @@
+/* @author: Morris Franken
+ * Measures the throughput and allocations of Args::parse along several axes, and writes the results as JSON
+ * (to stdout, or to the file given as first argument) such that they can be compared between releases.
+ */
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+
+#include "argparse/argparse.hpp"
+
+static size_t n_allocations = 0, n_bytes = 0;
+
+void *operator new(size_t size) {
+    n_allocations++;
+    n_bytes += size;
+    if (void *p = std::malloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+void *operator new(size_t size, std::align_val_t alignment) {     // used by std::pmr::new_delete_resource
+    n_allocations++;
+    n_bytes += size;
+    const size_t a = size_t(alignment);
+    if (void *p = std::aligned_alloc(a, (size + a - 1) / a * a))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+struct Result {
+    std::string name, axis;
+    size_t value, argc, iterations;
+    double ns_per_parse, allocations_per_parse, bytes_per_parse;
+};
+
+// Parse a fresh T (constructed by `make`) repeatedly, until at least `min_seconds` have passed
+template <typename F> Result run(const std::string &name, const std::string &axis, size_t value, const std::vector<std::string> &tokens, F &&make, double min_seconds = 0.2) {
+    std::vector<const char*> argv = {"argparse_bench"};
+    for (const std::string &t : tokens)
+        argv.emplace_back(t.c_str());
+
+    make()->parse(int(argv.size()), argv.data(), true);    // warm-up
+    const size_t allocations_before = n_allocations, bytes_before = n_bytes;
+    size_t iterations = 0;
+    double elapsed = 0;
+    const auto start = std::chrono::steady_clock::now();
+    while (elapsed < min_seconds || iterations < 3) {
+        make()->parse(int(argv.size()), argv.data(), true);
+        iterations++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    const double n = double(iterations);
+    return {name, axis, value, argv.size(), iterations, elapsed * 1e9 / n, double(n_allocations - allocations_before) / n, double(n_bytes - bytes_before) / n};
+}
+
+// A parser with a number of entries that is only known at runtime
+struct ManyArgs : public argparse::Args {
+    std::vector<std::reference_wrapper<int>> values;
+    explicit ManyArgs(size_t n_entries) {
+        values.reserve(n_entries);
+        for (size_t i = 0; i < n_entries; i++) {
+            int &v = kwarg("option-" + std::to_string(i), "An integer option").set_default(0);
+            values.emplace_back(v);
+        }
+    }
+};
+
+struct FlagArgs : public argparse::Args {
+    std::vector<std::reference_wrapper<bool>> flags;
+    FlagArgs() {
+        for (char c = 'a'; c <= 'z'; c++) {
+            bool &f = flag(std::string(1, c), "A short flag");
+            flags.emplace_back(f);
+        }
+    }
+};
+
+struct ListArgs : public argparse::Args {
+    std::vector<std::string_view> &files    = kwarg("files", "Multiple arguments").multi_argument().set_default("");
+    std::vector<int> &ints                  = kwarg("i,ints", "A vector of integers").set_default("");
+    std::vector<double> &doubles            = kwarg("d,doubles", "A vector of doubles").set_default("");
+};
+
+// The same options, declared with a dynamic Args and with a StaticSchema
+struct DynamicArgs : public argparse::Args {
+    std::string_view &src           = arg("Source");
+    int &k                          = kwarg("k,key", "An integer").set_default(3);
+    float &alpha                    = kwarg("a,alpha", "A float").set_default(0.5f);
+    std::vector<int> &numbers       = kwarg("n,numbers", "An int vector").set_default("");
+    std::optional<std::string> &out = kwarg("o,output", "An optional string");
+    bool &verbose                   = flag("v,verbose", "Verbose");
+    bool &quiet                     = flag("q,quiet", "Quiet");
+};
+
+struct Options {
+    std::string_view src;
+    int k = 3;
+    float alpha = 0.5f;
+    std::vector<int> numbers;
+    std::optional<std::string> out;
+    bool verbose = false, quiet = false;
+};
+
+static constexpr auto options_schema = argparse::make_schema(
+        argparse::arg(&Options::src, "Source"),
+        argparse::kwarg(&Options::k, "k,key", "An integer").set_default("3"),
+        argparse::kwarg(&Options::alpha, "a,alpha", "A float").set_default("0.5"),
+        argparse::kwarg(&Options::numbers, "n,numbers", "An int vector").set_default(""),
+        argparse::kwarg(&Options::out, "o,output", "An optional string"),
+        argparse::flag(&Options::verbose, "v,verbose", "Verbose"),
+        argparse::flag(&Options::quiet, "q,quiet", "Quiet"));
+
+struct StaticArgs {
+    Options options;
+    void parse(int argc, const char* const *argv, bool raise_on_error) { options = options_schema.parse(argc, argv, raise_on_error); }
+};
+
+#ifdef HAS_MAGIC_ENUM
+enum class Color { RED, GREEN, BLUE, CYAN, MAGENTA, YELLOW, BLACK, WHITE };
+struct EnumArgs : public argparse::Args {
+    std::vector<Color> &colors = kwarg("c,colors", "A vector of colors");
+};
+#endif
+
+std::string number_list(size_t n, const char *suffix = "") {
+    std::string list;
+    for (size_t i = 0; i < n; i++)
+        list.append(i? "," : "").append(std::to_string(i)).append(suffix);
+    return list;
+}
+
+int main(int argc, char *argv[]) {
+    std::vector<Result> results;
+    auto many = [](size_t n) { return [n]() { return std::make_unique<ManyArgs>(n); }; };
+
+    for (const size_t n : {8, 64, 512, 4096}) {     // declared entries, with a fixed commandline
+        results.emplace_back(run("entries", "declared entries", n, {"--option-0", "1", "--option-1", "2"}, many(n)));
+    }
+    for (const size_t n : {16, 256, 4096}) {        // every entry set on the commandline as `--key value`
+        std::vector<std::string> tokens;
+        for (size_t i = 0; i < n; i++) {
+            tokens.emplace_back("--option-" + std::to_string(i));
+            tokens.emplace_back(std::to_string(i));
+        }
+        results.emplace_back(run("argc", "argc", n * 2, tokens, many(n)));
+    }
+    for (const size_t n : {16, 256, 4096}) {        // every entry set on the commandline as `--key=value`
+        std::vector<std::string> tokens;
+        for (size_t i = 0; i < n; i++)
+            tokens.emplace_back("--option-" + std::to_string(i) + "=" + std::to_string(i));
+        results.emplace_back(run("equals", "argc", n, tokens, many(n)));
+    }
+    for (const size_t n : {1, 16, 256}) {           // clusters of short flags, e.g. `-abc...z`
+        const std::vector<std::string> tokens(n, "-abcdefghijklmnopqrstuvwxyz");
+        results.emplace_back(run("short_clusters", "clusters", n, tokens, []() { return std::make_unique<FlagArgs>(); }));
+    }
+    {   // the same commandline, parsed by a dynamic Args and by a StaticSchema
+        const std::vector<std::string> tokens = {"source", "-k", "5", "--alpha=0.25", "-n", "1,2,3", "-vq"};
+        results.emplace_back(run("dynamic_schema", "declared entries", 7, tokens, []() { return std::make_unique<DynamicArgs>(); }));
+        results.emplace_back(run("static_schema", "declared entries", 7, tokens, []() { return std::make_unique<StaticArgs>(); }));
+    }
+    auto list_args = []() { return std::make_unique<ListArgs>(); };
+    for (const size_t n : {16, 1024, 65536}) {      // values of a multi-argument, e.g. `--files f0 f1 ...`
+        std::vector<std::string> tokens = {"--files"};
+        for (size_t i = 0; i < n; i++)
+            tokens.emplace_back("f" + std::to_string(i));
+        results.emplace_back(run("multi_argument", "values", n, tokens, list_args));
+    }
+    for (const size_t n : {1000, 100000, 1000000}) { // a single large comma-separated list
+        results.emplace_back(run("vector_int", "elements", n, {"--ints=" + number_list(n)}, list_args));
+        results.emplace_back(run("vector_double", "elements", n, {"--doubles", number_list(n, ".5")}, list_args));
+    }
+#ifdef HAS_MAGIC_ENUM
+    for (const size_t n : {16, 1024, 65536}) {      // enum conversion of each element
+        static const char *names[] = {"red", "GREEN", "Blue", "cyan", "magenta", "yellow", "black", "white"};
+        std::string list;
+        for (size_t i = 0; i < n; i++)
+            list.append(i? "," : "").append(names[i % 8]);
+        results.emplace_back(run("enum", "elements", n, {"--colors", list}, []() { return std::make_unique<EnumArgs>(); }));
+    }
+#endif
+
+    std::ofstream file;
+    if (argc > 1)
+        file.open(argv[1]);
+    std::ostream &out = file.is_open()? file : std::cout;
+    out << "{\n  \"argparse_version\": " << ARGPARSE_VERSION << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"axis\": \"" << r.axis << "\", \"value\": " << r.value << ", \"argc\": " << r.argc
+            << ", \"iterations\": " << r.iterations << ", \"ns_per_parse\": " << r.ns_per_parse
+            << ", \"allocations_per_parse\": " << r.allocations_per_parse << ", \"bytes_per_parse\": " << r.bytes_per_parse
+            << "}" << (i + 1 < results.size()? "," : "") << "\n";
+    }
+    out << "  ]\n}" << std::endl;
+    return 0;
+}
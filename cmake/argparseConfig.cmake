@@ -0,0 +1,5 @@
+# Package configuration of argparse, which resolves the dependencies of the exported targets
+include(CMakeFindDependencyMacro)
+find_dependency(Threads)
+
+include(${CMAKE_CURRENT_LIST_DIR}/argparseTargets.cmake)
@@ -25,34 +25,103 @@
 // ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 // DEALINGS IN THE SOFTWARE.
 #include <cctype>              // for isdigit, tolower
+#include <cerrno>              // for errno, ERANGE
+#include <cstring>             // for memcpy
+#include <charconv>            // for from_chars
+#include <functional>          // for less, function
 #include <sstream>
 #include <cstdlib>             // for size_t, exit
-#include <algorithm>           // for max, transform, copy, min
-#include <iomanip>             // for operator<<, setw
-#include <iostream>            // for operator<<, basic_ostream, endl, ostream
-#include <iterator>            // for ostream_iterator
+#include <algorithm>           // for max, transform, copy, min, upper_bound
+#include <array>               // for array
+#include <chrono>              // for steady_clock
+#include <cstdint>             // for uint64_t, uint32_t
+#include <iterator>            // for forward_iterator_tag
+#include <limits>              // for numeric_limits
 #include <map>                 // for operator!=, map, _Rb_tree_iterator
+#include <unordered_set>       // for unordered_set
 #include <memory>              // for allocator, shared_ptr, __shared_ptr_ac...
+#include <memory_resource>     // for memory_resource, polymorphic_allocator
 #include <optional>            // for optional, nullopt
 #include <stdexcept>           // for runtime_error, invalid_argument
 #include <string>              // for string, operator+, basic_string, char_...
+#include <string_view>         // for string_view
+#include <system_error>        // for errc
 #include <type_traits>         // for declval, false_type, true_type, is_enum
-#include <utility>             // for move, pair
+#include <tuple>               // for tuple, get
+#include <utility>             // for move, pair, index_sequence
 #include <vector>              // for vector
 
+// Only needed by the implementation, which compiled-library mode leaves to src/argparse.cpp
+#if !defined(ARGPARSE_COMPILED_LIBRARY) || defined(ARGPARSE_INSTANTIATE)
+#include <atomic>              // for atomic
+#include <iomanip>             // for operator<<, setw
+#include <iostream>            // for operator<<, basic_ostream, endl, ostream
+#include <thread>              // for thread
+
+#ifdef _WIN32
+#include <fstream>             // for ifstream
+#include <io.h>                // for _read, _access
+#include <sys/stat.h>          // for _stat
+#else
+#include <fcntl.h>             // for open, O_RDONLY
+#include <sys/mman.h>          // for mmap, munmap, madvise
+#include <sys/stat.h>          // for fstat, stat
+#include <unistd.h>            // for close, read, access
+extern char **environ;         // POSIX, but not declared by all headers
+#endif
+#endif
+
 #if __has_include("magic_enum.hpp")
 #include <magic_enum.hpp>      // for enum_entries
 #define HAS_MAGIC_ENUM
 #endif
 
+// SIMD search for the delimiters of comma-separated lists, define ARGPARSE_NO_SIMD to use the scalar fallback only
+#if defined(__AVX2__) && !defined(ARGPARSE_NO_SIMD)
+#include <immintrin.h>         // for _mm256_cmpeq_epi8, _mm256_movemask_epi8
+#define ARGPARSE_SIMD_WIDTH 32
+#elif (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)) && !defined(ARGPARSE_NO_SIMD)
+#include <emmintrin.h>         // for _mm_cmpeq_epi8, _mm_movemask_epi8
+#define ARGPARSE_SIMD_WIDTH 16
+#else
+#define ARGPARSE_SIMD_WIDTH 0
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>            // for _BitScanForward, __popcnt
+#endif
+
+#if defined(__cpp_lib_to_chars)
+#define ARGPARSE_FLOAT_FROM_CHARS 1
+#else
+#define ARGPARSE_FLOAT_FROM_CHARS 0  // floating point from_chars is not available on all standard libraries, fall back to strtold
+#endif
+
 #define ARGPARSE_VERSION 4
 
+/* Compiled-library mode: with ARGPARSE_COMPILED_LIBRARY defined (as done by the `argparse_compiled` CMake target), the parser and the
+ * conversions of common types are only declared here and compiled once in src/argparse.cpp, instead of in every translation unit.
+ */
+#if defined(ARGPARSE_COMPILED_LIBRARY) && defined(ARGPARSE_INSTANTIATE)
+#define ARGPARSE_INLINE
+#define ARGPARSE_EXTERN
+#else
+#define ARGPARSE_INLINE inline
+#define ARGPARSE_EXTERN extern
+#endif
+
 namespace argparse {
-    using std::cout, std::cerr, std::endl, std::setw, std::size_t;
+    using std::size_t;
 
     template<typename T> struct is_vector : public std::false_type {};
     template<typename T, typename A> struct is_vector<std::vector<T, A>> : public std::true_type {};
 
+    template<typename T> class range_list;
+    template<typename T> struct is_range_list : public std::false_type {};
+    template<typename T> struct is_range_list<range_list<T>> : public std::true_type {};
+
+    template<typename T> struct is_string : public std::false_type {};
+    template<typename A> struct is_string<std::basic_string<char, std::char_traits<char>, A>> : public std::true_type {};
+
     template<typename T> struct is_optional : public std::false_type {};
     template<typename T> struct is_optional<std::optional<T>> : public std::true_type {};
 
@@ -62,7 +131,7 @@ namespace argparse {
     template <typename, typename = void> struct has_ostream_operator : std::false_type {};
     template <typename T> struct has_ostream_operator<T, decltype(void(std::declval<std::ostream&>() << std::declval<const T&>()))> : std::true_type {};
 
-    std::string bold(const std::string& input_str) {
+    inline std::string bold(const std::string& input_str) {
 #ifdef _WIN32
         return input_str; // no bold for windows
 #else
@@ -70,23 +139,110 @@ namespace argparse {
 #endif
     }
 
+    template<typename T> struct is_char : public std::bool_constant<std::is_same<T, char>::value || std::is_same<T, signed char>::value || std::is_same<T, unsigned char>::value> {};
+
+    // Types that toString formats, other than vectors of them
+    template<typename T> struct is_formattable : public std::bool_constant<std::is_arithmetic<T>::value || std::is_convertible<const T&, std::string_view>::value || has_ostream_operator<T>::value> {};
+    template<typename T> struct is_formattable_vector : public std::false_type {};
+    template<typename T, typename A> struct is_formattable_vector<std::vector<T, A>> : public is_formattable<T> {};
+
     template<typename T> std::string toString(const T &v) {
-        if constexpr (has_ostream_operator<T>::value) {
+        if constexpr (is_formattable_vector<T>::value) {
+            std::string text;
+            for (const auto &element : v)
+                text.append(text.empty()? "" : ",").append(toString(element));
+            return text;
+        } else if constexpr (std::is_same<T, bool>::value) {
+            return v? "true" : "false";
+        } else if constexpr (std::is_arithmetic<T>::value && !is_char<T>::value && (std::is_integral<T>::value || ARGPARSE_FLOAT_FROM_CHARS)) {
+            char buffer[64];    // numbers are formatted without a stringstream, which would allocate
+            return std::string(buffer, std::to_chars(buffer, buffer + sizeof(buffer), v).ptr);
+        } else if constexpr (std::is_convertible<const T&, std::string_view>::value) {
+            return std::string(std::string_view(v));
+        } else if constexpr (has_ostream_operator<T>::value) {
             return static_cast<std::ostringstream &&>((std::ostringstream() << std::boolalpha << v)).str();       // https://github.com/stan-dev/math/issues/590#issuecomment-550122627
         } else {
             return "unknown";
         }
     }
 
-    std::vector<std::string> inline split(const std::string &str) {
-        std::vector<std::string> splits;
-        std::stringstream ss(str);
-        std::string key;
-        while (std::getline(ss, key, ',')) {
-            if (!key.empty() && key.back() == '\0')
-                key.pop_back(); // last variables contain a '\0', which is unexpected when comparing to raw string, e.g. value == "test" will fail when the last character is '\0'. Therefore we can remove it
-            splits.emplace_back(std::move(key));
+#if ARGPARSE_SIMD_WIDTH
+    inline uint32_t count_trailing_zeros(uint32_t mask) {     // mask != 0
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return uint32_t(index);
+#else
+        return uint32_t(__builtin_ctz(mask));
+#endif
+    }
+
+    inline uint32_t count_bits(uint32_t mask) {
+#ifdef _MSC_VER
+        return uint32_t(__popcnt(mask));
+#else
+        return uint32_t(__builtin_popcount(mask));
+#endif
+    }
+
+    // A bit for each of the next ARGPARSE_SIMD_WIDTH bytes at `p` that equals `c`
+    inline uint32_t match_mask(const char *p, char c) {
+#if ARGPARSE_SIMD_WIDTH == 32
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(c))));
+#else
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(c))));
+#endif
+    }
+#endif
+
+    // The first ',' in [first, last), or last if there is none
+    inline const char *find_comma(const char *first, const char *last) {
+#if ARGPARSE_SIMD_WIDTH
+        for (; last - first >= ARGPARSE_SIMD_WIDTH; first += ARGPARSE_SIMD_WIDTH) {
+            if (const uint32_t mask = match_mask(first, ','))
+                return first + count_trailing_zeros(mask);
+        }
+#endif
+        for (; first != last && *first != ','; ++first) {}
+        return first;
+    }
+
+    // The number of ',' in [first, last)
+    inline size_t count_commas(const char *first, const char *last) {
+        size_t n = 0;
+#if ARGPARSE_SIMD_WIDTH
+        for (; last - first >= ARGPARSE_SIMD_WIDTH; first += ARGPARSE_SIMD_WIDTH)
+            n += count_bits(match_mask(first, ','));
+#endif
+        return n + size_t(std::count(first, last, ','));
+    }
+
+    // Call `f` on each element of a comma-separated string as a view of the original buffer, a trailing empty element is dropped (e.g. "1,2,3," yields 3 elements)
+    template <typename F> void for_each_split(std::string_view str, F &&f) {
+        const char *first = str.data(), *const last = str.data() + str.size();
+        while (first != last) {
+            const char *end = find_comma(first, last);
+            f(std::string_view(first, size_t(end - first)));
+            first = end == last? last : end + 1;
         }
+    }
+
+    // The element of a comma-separated list that starts at `offset`
+    inline std::string_view list_element(std::string_view v, size_t offset) {
+        return v.substr(offset, v.find(',', offset) - offset);
+    }
+
+    // Reserve room for `n` more elements, growing at least geometrically such that repeated appends stay amortized linear
+    template <typename V> void reserve_more(V &v, size_t n) {
+        if (v.capacity() < v.size() + n)
+            v.reserve(std::max(v.size() + n, 2 * v.capacity()));
+    }
+
+    std::vector<std::string_view> inline split(std::string_view str) {
+        std::vector<std::string_view> splits;
+        for_each_split(str, [&](std::string_view key) { splits.emplace_back(key); });
         return splits;
     }
 
@@ -96,26 +252,300 @@ namespace argparse {
         return str;
     }
 
-    template<typename T> inline T get(const std::string &v);
-    template<> inline std::string get(const std::string &v) { return v; }
-    template<> inline char get(const std::string &v) { return v.empty()? throw std::invalid_argument("empty string") : v.size() > 1?  v.substr(0,2) == "0x"? (char)std::stoul(v, nullptr, 16) : (char)std::stoi(v) : v[0]; }
-    template<> inline int get(const std::string &v) { return std::stoi(v); }
-    template<> inline short get(const std::string &v) { return std::stoi(v); }
-    template<> inline long get(const std::string &v) { return std::stol(v); }
-    template<> inline bool get(const std::string &v) { return to_lower(v) == "true" || v == "1"; }
-    template<> inline float get(const std::string &v) { return std::stof(v); }
-    template<> inline double get(const std::string &v) { return std::stod(v); }
-    template<> inline unsigned char get(const std::string &v) { return get<char>(v); }
-    template<> inline unsigned int get(const std::string &v) { return std::stoul(v); }
-    template<> inline unsigned short get(const std::string &v) { return std::stoul(v); }
-    template<> inline unsigned long get(const std::string &v) { return std::stoul(v); }
-
-    template<typename T> inline T get(const std::string &v) { // remaining types
-        if constexpr (is_vector<T>::value) {
-            const std::vector<std::string> splitted = split(v);
-            T res(splitted.size());
-            if (!v.empty())
-                std::transform (splitted.begin(), splitted.end(), res.begin(), get<typename T::value_type>);
+    inline bool iequals(std::string_view a, std::string_view b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) { return std::tolower((unsigned char)x) == std::tolower((unsigned char)y); });
+    }
+
+    /* Locale-independent conversion of numbers (and bools and chars) that never throws or allocates.
+     * The complete input (apart from surrounding spaces and a leading '+') must be a valid number that fits in T, a float may have an 'f' suffix (e.g. "0.5f").
+     * Chars are either a single character, a hexadecimal "0x.." or a decimal number. Bools are true for "true" (case-insensitive) or "1".
+     * Returns std::errc() on success, std::errc::invalid_argument or std::errc::result_out_of_range otherwise
+     */
+    template<typename T> std::errc from_string(std::string_view v, T &out) {
+        static_assert(std::is_arithmetic<T>::value, "from_string only supports arithmetic types");
+        if constexpr (std::is_same<T, bool>::value) {
+            out = iequals(v, "true") || v == "1";
+            return std::errc();
+        } else {
+            while (!v.empty() && v.front() == ' ') v.remove_prefix(1);
+            while (!v.empty() && v.back() == ' ') v.remove_suffix(1);
+            if (v.empty())
+                return std::errc::invalid_argument;
+            if constexpr (is_char<T>::value) {
+                if (v.size() == 1) {
+                    out = (T)v[0];
+                    return std::errc();
+                } else if (v.substr(0, 2) == "0x") {
+                    unsigned char hex = 0;
+                    auto [ptr, ec] = std::from_chars(v.data() + 2, v.data() + v.size(), hex, 16);
+                    out = (T)hex;
+                    return ec == std::errc() && ptr != v.data() + v.size()? std::errc::invalid_argument : ec;
+                }
+            }
+            if (v.size() > 1 && v[0] == '+' && v[1] != '-')   // from_chars does not accept a leading '+'
+                v.remove_prefix(1);
+            if constexpr (std::is_floating_point<T>::value) {
+                if (v.size() > 1 && (v.back() == 'f' || v.back() == 'F') && (std::isdigit((unsigned char)v[v.size() - 2]) || v[v.size() - 2] == '.'))
+                    v.remove_suffix(1);
+            }
+            if constexpr (std::is_floating_point<T>::value && !ARGPARSE_FLOAT_FROM_CHARS) {
+                char buffer[128];
+                if (v.size() >= sizeof(buffer))
+                    return std::errc::invalid_argument;
+                *std::copy(v.begin(), v.end(), buffer) = '\0';
+                char *end;
+                errno = 0;
+                const long double value = std::strtold(buffer, &end);
+                if (end != buffer + v.size())
+                    return std::errc::invalid_argument;
+                if (errno == ERANGE || value > std::numeric_limits<T>::max() || value < std::numeric_limits<T>::lowest())
+                    return std::errc::result_out_of_range;
+                out = (T)value;
+                return std::errc();
+            } else {
+                auto [ptr, ec] = std::from_chars(v.data(), v.data() + v.size(), out);
+                return ec == std::errc() && ptr != v.data() + v.size()? std::errc::invalid_argument : ec;
+            }
+        }
+    }
+
+    /* Fast path of from_string for plain decimal integers (e.g. "123" or "-45") that are short enough to never overflow T, of which the digits are accumulated directly.
+     * Returns false for any other input (spaces, a '+', hexadecimal chars, bools or long numbers), which is left to from_string
+     */
+    template<typename T> bool from_decimal(std::string_view v, T &out) {
+        if constexpr (std::is_integral<T>::value && !std::is_same<T, bool>::value && !is_char<T>::value) {
+            const bool negative = std::is_signed<T>::value && !v.empty() && v[0] == '-';
+            const size_t n_digits = v.size() - negative;
+            if (n_digits == 0 || n_digits > size_t(std::numeric_limits<T>::digits10))
+                return false;
+            uint64_t value = 0;
+            for (size_t k = negative; k < v.size(); k++) {
+                const unsigned digit = unsigned((unsigned char)v[k]) - '0';
+                if (digit > 9)
+                    return false;
+                value = value * 10 + digit;
+            }
+            out = negative? T(-int64_t(value)) : T(value);
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    // Throwing counterpart of from_string, used where the conversion is part of a larger get<T>
+    template<typename T> T from_string(std::string_view v) {
+        T out{};
+        const std::errc ec = from_string(v, out);
+        if (ec == std::errc::result_out_of_range)
+            throw std::runtime_error("out of range [" + std::to_string(+std::numeric_limits<T>::lowest()) + ", " + std::to_string(+std::numeric_limits<T>::max()) + "]");
+        else if (ec != std::errc())
+            throw std::invalid_argument(std::string(v));
+        return out;
+    }
+
+    /* A set of integers stored as sorted and merged inclusive ranges, parsed from lists like "0-1023,2048-4095,5000" (negative bounds are written as "-8--1").
+     * Membership tests are a binary search over the ranges, and iterating visits each number without materializing them
+     */
+    template<typename T> class range_list {
+        static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value, "range_list only supports integral types");
+    public:
+        using value_type = T;
+
+        struct Range {
+            T first, last;  // inclusive
+            bool operator==(const Range &other) const { return first == other.first && last == other.last; }
+        };
+
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            iterator(const Range *range, const Range *end) : range_(range), end_(end), value_(range != end? range->first : T{}) {}
+
+            reference operator*() const { return value_; }
+            pointer operator->() const { return &value_; }
+            iterator &operator++() {
+                if (value_ != range_->last)
+                    ++value_;
+                else if (++range_ != end_)
+                    value_ = range_->first;
+                else
+                    value_ = T{};
+                return *this;
+            }
+            iterator operator++(int) { iterator it = *this; ++*this; return it; }
+            bool operator==(const iterator &other) const { return range_ == other.range_ && value_ == other.value_; }
+            bool operator!=(const iterator &other) const { return !(*this == other); }
+
+        private:
+            const Range *range_, *end_;
+            T value_;
+        };
+
+        range_list() = default;
+        range_list(std::initializer_list<Range> ranges) {
+            for (const Range &range : ranges)
+                insert(range.first, range.last);
+        }
+
+        // Add [first, last], merging it with the ranges it overlaps or touches. Appending ranges in ascending order takes constant time
+        void insert(T first, T last) {
+            if (last < first)
+                std::swap(first, last);
+            if (ranges_.empty() || (ranges_.back().last < first && ranges_.back().last + 1 < first)) {
+                ranges_.push_back({first, last});
+                return;
+            }
+            // the ranges [lo, hi) overlap or touch [first, last]
+            auto lo = std::partition_point(ranges_.begin(), ranges_.end(), [&](const Range &r) { return r.last < first && r.last + 1 < first; });
+            auto hi = std::partition_point(lo, ranges_.end(), [&](const Range &r) { return !(r.first > last && r.first - 1 > last); });
+            if (lo == hi) {
+                ranges_.insert(lo, {first, last});
+            } else {
+                lo->first = std::min(lo->first, first);
+                lo->last = std::max((hi - 1)->last, last);
+                ranges_.erase(lo + 1, hi);
+            }
+        }
+
+        void insert(T value) { insert(value, value); }
+
+        [[nodiscard]] bool contains(T value) const {
+            auto it = std::upper_bound(ranges_.begin(), ranges_.end(), value, [](T v, const Range &r) { return v < r.first; });
+            return it != ranges_.begin() && value <= (it - 1)->last;
+        }
+
+        // The number of values, which wraps around to 0 for the complete range of a 64-bit type
+        [[nodiscard]] uint64_t size() const {
+            uint64_t n = 0;
+            for (const Range &r : ranges_)
+                n += uint64_t(r.last) - uint64_t(r.first) + 1;
+            return n;
+        }
+
+        [[nodiscard]] bool empty() const { return ranges_.empty(); }
+        void clear() { ranges_.clear(); }
+        [[nodiscard]] const std::vector<Range> &ranges() const { return ranges_; }
+
+        [[nodiscard]] iterator begin() const { return iterator(ranges_.data(), ranges_.data() + ranges_.size()); }
+        [[nodiscard]] iterator end() const { return iterator(ranges_.data() + ranges_.size(), ranges_.data() + ranges_.size()); }
+
+        bool operator==(const range_list &other) const { return ranges_ == other.ranges_; }
+        bool operator!=(const range_list &other) const { return ranges_ != other.ranges_; }
+
+        friend std::ostream &operator<<(std::ostream &os, const range_list &list) {
+            for (size_t i = 0; i < list.ranges_.size(); i++) {
+                const Range &r = list.ranges_[i];
+                os << (i? "," : "") << +r.first;
+                if (r.last != r.first)
+                    os << "-" << +r.last;
+            }
+            return os;
+        }
+
+    private:
+        std::vector<Range> ranges_;
+    };
+
+    // Convert a single element of a range_list, either a number "5" or a range "2-7"
+    template<typename T> std::errc from_string(std::string_view v, range_list<T> &out) {
+        while (!v.empty() && v.front() == ' ') v.remove_prefix(1);
+        const size_t dash = v.find('-', 1);     // a leading '-' is the sign of the first bound
+        T first{}, last{};
+        std::errc ec = from_string(v.substr(0, dash), first);
+        if (ec == std::errc() && dash != std::string_view::npos)
+            ec = from_string(v.substr(dash + 1), last);
+        else
+            last = first;
+        if (ec == std::errc() && last < first)
+            ec = std::errc::invalid_argument;
+        if (ec == std::errc())
+            out.insert(first, last);
+        return ec;
+    }
+
+    template<typename T> inline T get(std::string_view v);
+    template<> inline std::string get(std::string_view v) { return std::string(v); }
+    template<> inline std::string_view get(std::string_view v) { return v; }
+
+#ifdef HAS_MAGIC_ENUM
+    constexpr char fold_case(char c) {
+        return c >= 'A' && c <= 'Z'? char(c - 'A' + 'a') : c;
+    }
+
+    constexpr uint64_t fold_case_hash(std::string_view str) {   // FNV-1a of the lower-case string
+        uint64_t hash = 14695981039346656037ull;
+        for (const char c : str)
+            hash = (hash ^ (unsigned char)fold_case(c)) * 1099511628211ull;
+        return hash;
+    }
+
+    /* Case-insensitive lookup table of the names of enum T, built once at compile time. The entries are sorted on the hash of their
+     * lower-case name, such that a conversion is a binary search on the hash and a single case-insensitive compare, without allocations
+     */
+    template <typename T> struct EnumTable {
+        struct Item {
+            uint64_t hash = 0;
+            T value{};
+            std::string_view name;
+        };
+
+        static constexpr auto build() {
+            constexpr auto &entries = magic_enum::enum_entries<T>();
+            std::array<Item, entries.size()> items{};
+            for (size_t n = 0; n < entries.size(); n++) {
+                const Item item = {fold_case_hash(entries[n].second), entries[n].first, entries[n].second};
+                size_t i = n;
+                for (; i > 0 && item.hash < items[i - 1].hash; i--)    // insertion sort
+                    items[i] = items[i - 1];
+                items[i] = item;
+            }
+            return items;
+        }
+
+        static constexpr auto items = build();
+
+        static const T *find(std::string_view name) {
+            const uint64_t hash = fold_case_hash(name);
+            const Item *it = std::lower_bound(items.data(), items.data() + items.size(), hash, [](const Item &item, uint64_t h) { return item.hash < h; });
+            for (; it != items.data() + items.size() && it->hash == hash; ++it) {
+                if (iequals(it->name, name))
+                    return &it->value;
+            }
+            return nullptr;
+        }
+
+        // The lower-case names in declaration order as "a, b, c, ", formatted once
+        static std::string_view allowed() {
+            static const std::string allowed = [] {
+                std::string str;
+                for (const auto &[value, name] : magic_enum::enum_entries<T>())
+                    str.append(to_lower(name)).append(", ");
+                return str;
+            }();
+            return allowed;
+        }
+    };
+#endif
+
+    template <typename T> std::errc append_list_to(std::string_view v, T &data, size_t *offset = nullptr);
+
+    template<typename T> inline T get(std::string_view v) { // remaining types
+        if constexpr (std::is_arithmetic<T>::value) {
+            return from_string<T>(v);
+        } else if constexpr (is_vector<T>::value || is_range_list<T>::value) {
+            T res;
+            size_t offset = 0;
+            if (append_list_to(v, res, &offset) != std::errc()) {
+                if constexpr (std::is_arithmetic<typename T::value_type>::value && is_vector<T>::value)
+                    from_string<typename T::value_type>(list_element(v, offset));   // throws the error of the element
+                else if constexpr (is_range_list<T>::value)
+                    throw std::invalid_argument(std::string(list_element(v, offset)));
+            }
             return res;
         } else if constexpr (std::is_pointer<T>::value) {
             return new typename std::remove_pointer<T>::type(get<typename std::remove_pointer<T>::type>(v));
@@ -125,31 +555,240 @@ namespace argparse {
             return get<typename T::value_type>(v);
         } else if constexpr (std::is_enum<T>::value) {  // case-insensitive enum conversion
 #ifdef HAS_MAGIC_ENUM
-            constexpr auto& enum_entries = magic_enum::enum_entries<T>();
-            const std::string lower_str = to_lower(v);
-            for (const auto &[value, name] : enum_entries) {
-                if (to_lower(name) == lower_str)
-                    return value;
-            }
-            std::string error = "enum is only accepting [";
-            for (size_t i = 0; i < enum_entries.size(); i++)
-                error += (i==0? "" : ", ") + to_lower(enum_entries[i].second);
-            error += "]";
-            throw std::runtime_error(error);
+            if (const T *value = EnumTable<T>::find(v))
+                return *value;
+            const std::string_view allowed = EnumTable<T>::allowed();
+            throw std::runtime_error("enum is only accepting [" + std::string(allowed.substr(0, allowed.size() - std::min<size_t>(allowed.size(), 2))) + "]");
 #else
             throw std::runtime_error("Enum not supported, please install magic_enum (https://github.com/Neargye/magic_enum)");
 #endif
-        } else {
+        } else if constexpr (std::is_constructible<T, std::string_view>::value) {
             return T(v);
+        } else {
+            return T(std::string(v));   // custom classes with a std::string constructor require an owned copy
+        }
+    }
+
+    /* Conversions of a value into the storage of an entry, used by both the converters of Args and by StaticSchema.
+     * Conversions of numbers report errors through the returned std::errc, other types may throw
+     */
+    template <typename U> std::errc convert_to(std::string_view v, U &out) {
+        if constexpr (std::is_arithmetic<U>::value) {
+            return from_string(v, out);
+        } else if constexpr (is_string<U>::value) {
+            out.assign(v);  // keeps the allocator of the string
+            return std::errc();
+        } else {
+            out = get<U>(v);
+            return std::errc();
+        }
+    }
+
+    // Add a single element to a vector (or a range to a range_list), without splitting on ','. Other types simply take the last value
+    template <typename T> std::errc append_to(std::string_view v, T &data) {
+        if constexpr (is_range_list<T>::value) {
+            return from_string(v, data);
+        } else if constexpr (is_vector<T>::value) {
+            typename T::value_type value{};
+            const std::errc ec = convert_to(v, value);
+            if (ec == std::errc())
+                data.emplace_back(std::move(value));
+            return ec;
+        } else {
+            return convert_to(v, data);
+        }
+    }
+
+    /* Add all elements of a comma-separated list of numbers to a vector, which is reserved once for all of them (growing geometrically for repeated keys). The delimiters are found with SIMD,
+     * and plain decimal integers are converted without from_chars. On failure, `offset` receives the offset of the first bad element, the elements before it are kept
+     */
+    template <typename T> std::errc append_numbers_to(std::string_view v, T &data, size_t &offset) {
+        using V = typename T::value_type;
+        const char *const begin = v.data(), *const end = v.data() + v.size();
+        reserve_more(data, count_commas(begin, end) + 1);
+        for (const char *first = begin; first != end;) {
+            const char *last = find_comma(first, end);
+            const std::string_view element(first, size_t(last - first));
+            V value{};
+            if (!from_decimal(element, value)) {
+                const std::errc ec = from_string(element, value);
+                if (ec != std::errc()) {
+                    offset = size_t(first - begin);
+                    return ec;
+                }
+            }
+            data.push_back(value);
+            first = last == end? end : last + 1;
+        }
+        return std::errc();
+    }
+
+    /* Add all elements of a comma-separated list to a vector. When given, `offset` receives the offset of the element that failed to convert (or threw),
+     * which is written before each element is converted
+     */
+    template <typename T> std::errc append_list_to(std::string_view v, T &data, size_t *offset) {
+        if constexpr (is_range_list<T>::value) {
+            std::errc ec = std::errc();
+            for_each_split(v, [&](std::string_view element) {
+                if (ec == std::errc() && (ec = from_string(element, data)) != std::errc() && offset)
+                    *offset = size_t(element.data() - v.data());
+            });
+            return ec;
+        } else if constexpr (is_vector<T>::value) {
+            size_t element_offset = 0;
+            if constexpr (std::is_arithmetic<typename T::value_type>::value) {
+                return append_numbers_to(v, data, offset? *offset : element_offset);
+            } else {
+                reserve_more(data, count_commas(v.data(), v.data() + v.size()) + 1);
+                std::errc ec = std::errc();
+                for_each_split(v, [&](std::string_view element) {
+                    if (ec == std::errc()) {
+                        (offset? *offset : element_offset) = size_t(element.data() - v.data());
+                        ec = append_to(element, data);
+                    }
+                });
+                return ec;
+            }
+        } else {
+            return convert_to(v, data);
+        }
+    }
+
+    // Replace the contents by the (comma-separated) value
+    template <typename T> std::errc assign_to(std::string_view v, T &data, size_t *offset = nullptr) {
+        if constexpr (is_vector<T>::value || is_range_list<T>::value)
+            data.clear();
+        return append_list_to(v, data, offset);
+    }
+
+    template <typename T> std::string_view allowed_entries() {
+#ifdef HAS_MAGIC_ENUM
+        if constexpr (std::is_enum<T>::value)
+            return EnumTable<T>::allowed();
+#endif
+        return {};
+    }
+
+    /* Binary encoding of the converted data in snapshots (see Args::snapshot), in native byte order as the images are only
+     * shared between processes of the same program. Supports numbers, enums, strings, and vectors and optionals of these
+     */
+    template <typename T> constexpr bool is_snapshot_type() {
+        if constexpr (std::is_arithmetic<T>::value || std::is_enum<T>::value || is_string<T>::value || std::is_same<T, std::string_view>::value)
+            return true;
+        else if constexpr (is_vector<T>::value || is_optional<T>::value)
+            return is_snapshot_type<typename T::value_type>();
+        else
+            return false;
+    }
+
+    template <typename T> void write_pod(std::string &out, const T &value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T> bool read_pod(std::string_view &in, T &value) {
+        if (in.size() < sizeof(T))
+            return false;
+        std::memcpy(&value, in.data(), sizeof(T));
+        in.remove_prefix(sizeof(T));
+        return true;
+    }
+
+    inline void write_bytes(std::string &out, std::string_view bytes) {
+        write_pod(out, uint64_t(bytes.size()));
+        out.append(bytes);
+    }
+
+    inline bool read_bytes(std::string_view &in, std::string_view &bytes) {
+        uint64_t size = 0;
+        if (!read_pod(in, size) || in.size() < size)
+            return false;
+        bytes = in.substr(0, size);
+        in.remove_prefix(size);
+        return true;
+    }
+
+    template <typename T> void save_value(const T &value, std::string &out) {
+        if constexpr (std::is_arithmetic<T>::value || std::is_enum<T>::value) {
+            write_pod(out, value);
+        } else if constexpr (is_string<T>::value || std::is_same<T, std::string_view>::value) {
+            write_bytes(out, value);
+        } else if constexpr (is_vector<T>::value) {
+            using E = typename T::value_type;
+            write_pod(out, uint64_t(value.size()));
+            if constexpr (std::is_arithmetic<E>::value && !std::is_same<E, bool>::value)   // std::vector<bool> is not contiguous
+                out.append(reinterpret_cast<const char*>(value.data()), value.size() * sizeof(E));
+            else
+                for (const E &element : value)
+                    save_value(E(element), out);
+        } else if constexpr (is_optional<T>::value) {
+            write_pod(out, uint8_t(value.has_value()));
+            if (value.has_value())
+                save_value(*value, out);
+        }
+    }
+
+    // Strings views refer into `in`, which therefore needs to outlive the value
+    template <typename T> bool load_value(std::string_view &in, T &value) {
+        if constexpr (std::is_arithmetic<T>::value || std::is_enum<T>::value) {
+            return read_pod(in, value);
+        } else if constexpr (is_string<T>::value) {
+            std::string_view bytes;
+            if (!read_bytes(in, bytes))
+                return false;
+            value.assign(bytes);    // keeps the allocator of the string
+            return true;
+        } else if constexpr (std::is_same<T, std::string_view>::value) {
+            return read_bytes(in, value);
+        } else if constexpr (is_vector<T>::value) {
+            using E = typename T::value_type;
+            uint64_t size = 0;
+            if (!read_pod(in, size))
+                return false;
+            value.clear();
+            if constexpr (std::is_arithmetic<E>::value && !std::is_same<E, bool>::value) {
+                if (in.size() / sizeof(E) < size)
+                    return false;
+                value.resize(size);
+                std::memcpy(value.data(), in.data(), size * sizeof(E));
+                in.remove_prefix(size * sizeof(E));
+            } else {
+                for (uint64_t k = 0; k < size; k++) {
+                    E element{};
+                    if (!load_value(in, element))
+                        return false;
+                    value.emplace_back(std::move(element));
+                }
+            }
+            return true;
+        } else if constexpr (is_optional<T>::value) {
+            uint8_t has_value = 0;
+            if (!read_pod(in, has_value))
+                return false;
+            value.reset();
+            if (has_value)
+                return load_value(in, value.emplace());
+            return true;
+        } else {
+            return false;
         }
     }
 
     struct ConvertBase {
         virtual ~ConvertBase() = default;
-        virtual void convert(const std::string &v) = 0;
-        virtual void set_default(const std::unique_ptr<ConvertBase> &default_value, const std::string &default_string) = 0;
+        virtual std::errc convert(std::string_view v, size_t *offset = nullptr) = 0;   // `offset` receives the offset of a bad element of a list
+        virtual std::errc append(std::string_view v) = 0;         // add a single element to a vector, without splitting on ','
+        virtual std::errc append_list(std::string_view v, size_t *offset = nullptr) = 0;    // add all elements of a comma-separated list to a vector
+        virtual void reserve(size_t n) = 0;                  // capacity hint for `n` more appended elements
+        virtual void clear() = 0;
+        virtual void set_default(const ConvertBase &default_value) = 0;   // copy the data of a default of the same type
+        [[nodiscard]] virtual std::string to_string() const = 0;   // the data as text, only used for help and print
+        virtual bool to_texts(std::pmr::vector<std::pmr::string> &out) const = 0;  // append the data (or each element of a vector) as text, false if it cannot be formatted
         [[nodiscard]] virtual size_t get_type_id() const = 0;
-        [[nodiscard]] virtual std::string get_allowed_entries() const = 0;
+        [[nodiscard]] virtual std::string_view get_allowed_entries() const = 0;
+        [[nodiscard]] virtual bool is_streamable() const = 0;    // a vector whose elements can be streamed, as they do not refer to the text
+        [[nodiscard]] virtual bool is_list() const = 0;          // a vector or range_list, of which each value is a comma-separated list
+        virtual bool save(std::string &out) const = 0;            // append the data to a snapshot, returns false for unsupported types
+        virtual bool load(std::string_view &in) = 0;
     };
 
     template <typename T> struct ConvertType : public ConvertBase {
@@ -157,335 +796,2465 @@ namespace argparse {
         ~ConvertType() override = default;
         ConvertType() : ConvertBase() {};
         explicit ConvertType(const T &value) : ConvertBase(), data(value) {};
+        // Allocator-aware types (e.g. std::pmr::vector, std::pmr::string) will allocate their data from `resource`
+        explicit ConvertType(std::pmr::memory_resource *resource) : ConvertBase(), data(make_data(resource)) {};
 
-        void convert(const std::string &v) override {
-            data = get<T>(v);
+        static T make_data(std::pmr::memory_resource *resource) {
+            if constexpr (std::uses_allocator<T, std::pmr::polymorphic_allocator<char>>::value)
+                return T(std::pmr::polymorphic_allocator<char>(resource));
+            else
+                return T();
         }
 
-        void set_default(const std::unique_ptr<ConvertBase> &default_value, const std::string &default_string) override {
-            if (this->get_type_id() == default_value->get_type_id())    // When the types do not match exactly. resort to string conversion
-                data = ((ConvertType<T>*)(default_value.get()))->data;
-            else
-                data = get<T>(default_string);
+        std::errc convert(std::string_view v, size_t *offset) override {
+            return assign_to(v, data, offset);
         }
 
-        [[nodiscard]] size_t get_type_id() const override {
-            return typeid(T).hash_code();
+        std::errc append(std::string_view v) override {
+            return append_to(v, data);
         }
 
-        [[nodiscard]] std::string get_allowed_entries() const override {
-            std::stringstream ss;
+        std::errc append_list(std::string_view v, size_t *offset) override {
+            return append_list_to(v, data, offset);
+        }
 
-#ifdef HAS_MAGIC_ENUM
-            if constexpr (std::is_enum<T>::value) {
-                for (const auto &[value, name] : magic_enum::enum_entries<T>()) {
-                    ss << to_lower(name) << ", ";
-                }
-            }
-#endif
+        void reserve(size_t n) override {
+            if constexpr (is_vector<T>::value)
+                reserve_more(data, n);
+        }
 
-            return ss.str();
+        void clear() override {
+            if constexpr (is_vector<T>::value || is_range_list<T>::value)
+                data.clear();
         }
-    };
 
-    struct Entry {
-        enum ARG_TYPE {ARG, KWARG, FLAG} type;
+        void set_default(const ConvertBase &default_value) override {
+            data = ((const ConvertType<T>&)(default_value)).data;
+        }
 
-        Entry(ARG_TYPE type, const std::string& key, std::string help, std::optional<std::string> implicit_value=std::nullopt) :
-                type(type),
-                keys_(split(key)),
-                help(std::move(help)),
-                implicit_value_(std::move(implicit_value)) {
+        [[nodiscard]] std::string to_string() const override {
+            return toString(data);
         }
 
-        // Allow both string inputs and direct-type inputs. Where a string-input will be converted like it would when using the commandline, and the direct approach is to simply use the value provided.
-        template <typename T> Entry &set_default(const T &default_value) {
-            this->default_str_ = toString(default_value);
-            if constexpr (!(std::is_array<T>::value || std::is_same<typename std::remove_all_extents<T>::type, char>::value)) {
-                data_default = std::make_unique<ConvertType<T>>(default_value);
+        bool to_texts(std::pmr::vector<std::pmr::string> &out) const override {
+            if constexpr (is_formattable_vector<T>::value) {
+                for (const auto &element : data)
+                    out.emplace_back(toString(element));
+                return true;
+            } else if constexpr (!is_vector<T>::value && is_formattable<T>::value) {
+                out.emplace_back(toString(data));
+                return true;
+            } else {
+                return false;
             }
-            return *this;
         }
 
-        Entry &multi_argument() {
-            _is_multi_argument = true;
-            return *this;
+        [[nodiscard]] size_t get_type_id() const override {
+            return typeid(T).hash_code();
         }
 
-        // Magically convert the value string to the requested type
-        template <typename T> operator T&() {
-            // Automatically set the default to nullptr for pointer types and empty for optional types
-            if constexpr (is_optional<T>::value || std::is_pointer<T>::value || is_shared_ptr<T>::value) {
-                if (!default_str_.has_value()) {
-                    default_str_ = "none";
-                    if constexpr(is_optional<T>::value) {
-                        data_default = std::make_unique<ConvertType<T>> (T{std::nullopt});
-                    } else {
-                        data_default = std::make_unique<ConvertType<T>> ((T) nullptr);
-                    }
-                }
-            }
+        [[nodiscard]] std::string_view get_allowed_entries() const override {
+            return allowed_entries<T>();
+        }
 
-            datap = std::make_unique<ConvertType<T>>();
-            return ((ConvertType<T>*)(datap.get()))->data;
-        };
+        [[nodiscard]] bool is_streamable() const override {
+            if constexpr (is_vector<T>::value)
+                return !std::is_same<typename T::value_type, std::string_view>::value;
+            else
+                return is_range_list<T>::value;
+        }
 
-        // Force an ambiguous error when not using a reference.
-        template <typename T> operator T() {} // When you get here  because you received an error, make sure all parameters of argparse are references (e.g. with `&`)
+        [[nodiscard]] bool is_list() const override {
+            return is_vector<T>::value || is_range_list<T>::value;
+        }
 
-    private:
-        std::vector<std::string> keys_;
-        std::string help;
-        std::optional<std::string> value_;
-        std::optional<std::string> implicit_value_;
-        std::optional<std::string> default_str_;
-        std::string error;
-        std::unique_ptr<ConvertBase> datap;
-        std::unique_ptr<ConvertBase> data_default;
-        bool _is_multi_argument = false;
-        bool is_set_by_user = true;
-
-        [[nodiscard]] std::string _get_keys() const {
-            std::stringstream ss;
-            for (size_t i = 0; i < keys_.size(); i++)
-                ss << (i? "," : "") << (type == ARG? "" : (keys_[i].size() > 1 ? "--" : "-")) + keys_[i];
-            return ss.str();
-        }
-
-        void _convert(const std::string &value) {
-            try {
-                this->value_ = value;
-                datap->convert(value);
-            } catch (const std::invalid_argument &e) {
-                error = "Invalid argument, could not convert \"" + value + "\" for " + _get_keys() + " (" + help + ")";
-            } catch (const std::runtime_error &e) {
-                error = "Invalid argument \"" + value + "\" for " + _get_keys() + " (" + help + "). Error: " + e.what();
-            }
-        }
-
-        void _apply_default() {
-            is_set_by_user = false;
-            if (data_default != nullptr) {
-                value_ = *default_str_; // for printing
-                datap->set_default(data_default, *default_str_);
-            } else if (default_str_.has_value()) {   // in cases where a string is provided to the `set_default` function
-                _convert(default_str_.value());
-            } else {
-                error = "Argument missing: " + _get_keys() + " (" + help + ")";
-            }
+        bool save(std::string &out) const override {
+            if constexpr (is_snapshot_type<T>())
+                save_value(data, out);
+            return is_snapshot_type<T>();
         }
 
-        [[nodiscard]] std::string info() const {
-            const std::string allowed_entries = datap->get_allowed_entries();
-            const std::string default_value = default_str_.has_value() ? "default: " + *default_str_ : "required";
-            const std::string implicit_value = implicit_value_.has_value() ? "implicit: \"" + *implicit_value_ + "\", ": "";
-            const std::string allowed_value = !allowed_entries.empty()? "allowed: <" + allowed_entries.substr(0, allowed_entries.size()-2) + ">, ": "";
-            return " [" + allowed_value + implicit_value + default_value + "]";
+        bool load(std::string_view &in) override {
+            return load_value(in, data);
         }
+    };
 
-        friend class Args;
+    // Deleter for objects allocated from a std::pmr::memory_resource, returning the memory to the resource it came from
+    struct ResourceDeleter {
+        std::pmr::memory_resource *resource = nullptr;
+        size_t size = 0, alignment = 0;
+
+        template <typename T> void operator()(T *p) const {
+            p->~T();
+            resource->deallocate(p, size, alignment);
+        }
     };
 
-    class Args {
-    private:
-        size_t _arg_idx = 0;
-        std::string program_name;
-        std::vector<std::string> params;
-        std::vector<std::shared_ptr<Entry>> all_entries;
-        std::map<std::string, std::shared_ptr<Entry>> kwarg_entries;
-        std::vector<std::shared_ptr<Entry>> arg_entries;
+    // Construct a T (as a Base) in memory allocated from `resource`
+    template <typename Base, typename T, typename... Ts> std::unique_ptr<Base, ResourceDeleter> make_unique_in(std::pmr::memory_resource *resource, Ts&&... args) {
+        void *p = resource->allocate(sizeof(T), alignof(T));
+        try {
+            return std::unique_ptr<Base, ResourceDeleter>(new (p) T(std::forward<Ts>(args)...), ResourceDeleter{resource, sizeof(T), alignof(T)});
+        } catch (...) {
+            resource->deallocate(p, sizeof(T), alignof(T));
+            throw;
+        }
+    }
+
+    using ConvertPtr = std::unique_ptr<ConvertBase, ResourceDeleter>;
 
+    template <typename T, typename... Ts> ConvertPtr make_convert(std::pmr::memory_resource *resource, Ts&&... args) {
+        return make_unique_in<ConvertBase, ConvertType<T>>(resource, std::forward<Ts>(args)...);
+    }
+
+    class Args;
+
+    /* Handle to a declared argument, returned by `Args::arg`, `Args::kwarg` and `Args::flag`.
+     * The declaration itself is stored in the entry tables of Args, this handle only allows to modify it and collapses into the requested type in `Entry::operator T&()`
+     */
+    class Entry {
     public:
-        virtual ~Args() = default;
+        enum ARG_TYPE : uint8_t {ARG, KWARG, FLAG};
 
-        /* Add a positional argument, the order in which it is defined equals the order in which they are being read.
-         * help : Description of the variable
-         *
-         * Returns a reference to the Entry, which will collapse into the requested type in `Entry::operator T()`
-         */
-        Entry &arg(const std::string &help) {
-            std::shared_ptr<Entry> entry = std::make_shared<Entry>(Entry::ARG, "arg_" + std::to_string(_arg_idx++), help);
-            arg_entries.emplace_back(entry);
-            all_entries.emplace_back(entry);
-            return *entry;
-        }
+        // Allow both string inputs and direct-type inputs. Where a string-input will be converted like it would when using the commandline, and the direct approach is to simply use the value provided.
+        template <typename T> Entry &set_default(const T &default_value);
 
-        /* Add a Key-Worded argument that takes a variable.
-         * key : A comma-separated string, e.g. "k,key", which denotes the short (-k) and long(--key) keys_
-         * help : Description of the variable
-         * implicit_value : Implicit values are used when no value is provided.
-         *
-         * Returns a reference to the Entry, which will collapse into the requested type in `Entry::operator T()`
-         */
-        Entry &kwarg(const std::string &key, const std::string &help, const std::optional<std::string>& implicit_value=std::nullopt) {
-            std::shared_ptr<Entry> entry = std::make_shared<Entry>(Entry::KWARG, key, help, implicit_value);
-            all_entries.emplace_back(entry);
-            for (const std::string &k : entry->keys_) {
-                kwarg_entries[k] = entry;
-            }
-            return *entry;
-        }
+        Entry &multi_argument();
 
-        /* Add a flag which will be false by default.
-         * key : A comma-separated string, e.g. "k,key", which denotes the short (-k) and long(--key) keys_
-         * help : Description of the variable
-         *
-         * Returns reference to Entry like kwarg
-         */
-        Entry &flag(const std::string &key, const std::string &help) {
-            return kwarg(key, help, "true").set_default<bool>(false);
-        }
+        // Use the environment variable `name` when the argument is not given on the commandline, which takes precedence over the default
+        Entry &env(std::string_view name);
 
-        virtual void welcome() {}       // Allow to overwrite the `welcome` function to add a welcome-message to the help output
-        virtual void help() {
-            welcome();
-            cout << "Usage: " << program_name << " ";
-            for (const auto &entry : arg_entries)
-                cout << entry->keys_[0] << ' ';
-            cout << " [options...]" << endl;
-            for (const auto &entry : arg_entries) {
-                cout << setw(17) << entry->keys_[0] << " : " << entry->help << entry->info() << endl;
-            }
-
-            cout << endl << "Options:" << endl;
-            for (const auto &entry : all_entries) {
-                if (entry->type != Entry::ARG) {
-                    cout << setw(17) << entry->_get_keys() << " : " << entry->help << entry->info() << endl;
-                }
-            }
-        }
+        /* Read a configuration file from the path given by this argument, e.g. `kwarg("config", "Configuration file").config_file().set_default("app.ini")`.
+         * Its `key = value` lines are used for arguments (by their keys) that are not given on the commandline or by the environment
+         */
+        Entry &config_file();
 
-        void validate(const bool &raise_on_error) {
-            for (const auto &entry : all_entries) {
-                if (!entry->error.empty()) {
-                    if (raise_on_error) {
-                        throw std::runtime_error(entry->error);
-                    } else {
-                        std::cerr << entry->error << std::endl;
-                        exit(-1);
-                    }
-                }
-            }
-        }
+        // Take new values when the options are reloaded by a Reloadable, other entries keep the values of the first parse
+        Entry &reloadable();
 
-        /* parse all parameters and also check for the help_flag which was set in this constructor
-         * Upon error, it will print the error and exit immediately.
+        /* Checks of the values (e.g. paths), which run concurrently for all values after parsing, such that every failing value is reported in one pass.
+         * Each element of a list is checked separately, and defaults are checked like given values
          */
-        void parse(int argc, const char* const *argv, const bool &raise_on_error) {
-            program_name = argv[0];
-            params = std::vector<std::string>(argv + 1, argv + argc);
+        Entry &must_exist();
+        Entry &readable();
+        Entry &writable_dir();
+        // A custom check, `predicate` may be called from any thread and `message` describes a failure, e.g. "is not a PNG file"
+        Entry &satisfies(std::function<bool(std::string_view value)> predicate, std::string_view message);
 
-            bool& _help = flag("help", "print help");
+        // Magically convert the value string to the requested type
+        template <typename T> operator T&();
 
-            auto is_value = [&](const size_t &i) -> bool {
-                return params.size() > i && (params[i][0] != '-' || (params[i].size() > 1 && std::isdigit(params[i][1])));  // check for number to not accidentally mark negative numbers as non-parameter
-            };
-            auto parse_param = [&](size_t &i, const std::string &key, const bool is_short, const std::optional<std::string> &equal_value=std::nullopt) {
-                auto itt = kwarg_entries.find(key);
-                if (itt != kwarg_entries.end()) {
-                    auto &entry = itt->second;
-                    if (equal_value.has_value()) {
-                        entry->_convert(equal_value.value());
-                    } else if (entry->implicit_value_.has_value()) {
-                        entry->_convert(*entry->implicit_value_);
-                    } else if (!is_short) { // short values are not allowed to look ahead for the next parameter
-                        if (is_value(i + 1)) {
-                            std::string value = params[++i];
-                            if (entry->_is_multi_argument) {
-                                while (is_value(i + 1))
-                                    value += "," + params[++i];
-                            }
-                            entry->_convert(value);
-                        } else if (entry->_is_multi_argument) {
-                            entry->_convert("");    // for multiargument parameters, return an empty vector when not passing any more values
-                        } else {
-                            entry->error = "No value provided for: " + key;
-                        }
+        // Force an ambiguous error when not using a reference.
+        template <typename T> operator T() {} // When you get here  because you received an error, make sure all parameters of argparse are references (e.g. with `&`)
+
+    private:
+        Entry(Args &args, uint32_t index) : args(args), index(index) {}
+
+        Args &args;
+        uint32_t index;
+
+        friend class Args;
+    };
+
+    /* Perfect hash table from keys to values, with a direct lookup table for single-character keys.
+     * Built once when parsing starts, such that every lookup costs a single hash and exactly one probe, without allocating.
+     * Keys are first hashed into buckets, and for each bucket a displacement is searched that maps its keys to free slots (hash-and-displace)
+     */
+    template <typename T> class KeyIndex {
+    public:
+        explicit KeyIndex(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) : slots_(resource), displacements_(resource) {}
+
+        template <typename Map> void build(const Map &entries) {
+            short_keys_.fill(std::nullopt);
+            slots_.clear();
+            displacements_.clear();
+            std::pmr::vector<std::pair<std::string_view, T>> long_keys(slots_.get_allocator());
+            for (const auto &[key, value] : entries) {
+                if (key.size() == 1)
+                    short_keys_[(unsigned char)key[0]] = value;
+                else
+                    long_keys.emplace_back(key, value);
+            }
+            if (long_keys.empty())
+                return;
+
+            for (seed_ = 0; !try_build(long_keys); seed_++) {}   // only retries in the rare case a bucket cannot be placed
+        }
+
+        // Returns a pointer to the value of `key`, or nullptr when it is not in the index
+        [[nodiscard]] const T *find(std::string_view key) const {
+            if (key.size() == 1) {
+                const auto &value = short_keys_[(unsigned char)key[0]];
+                return value.has_value()? &*value : nullptr;
+            }
+            if (slots_.empty())
+                return nullptr;
+            const uint64_t h = hash(key, seed_);
+            const auto &slot = slots_[this->slot(h, displacements_[h % displacements_.size()])];
+            return slot.first.data() != nullptr && slot.first == key? &slot.second : nullptr;
+        }
+
+    private:
+        std::array<std::optional<T>, 256> short_keys_{};
+        std::pmr::vector<std::pair<std::string_view, T>> slots_;   // an empty slot has a null key
+        std::pmr::vector<uint32_t> displacements_;
+        uint64_t seed_ = 0;
+
+        static uint64_t hash(std::string_view key, uint64_t seed) {     // FNV-1a, with a full avalanche such that keys that only differ in their last character do not share their low bits
+            uint64_t h = 14695981039346656037ull ^ (seed * 0x9E3779B97F4A7C15ull);
+            for (const char c : key)
+                h = (h ^ (unsigned char)c) * 1099511628211ull;
+            h = (h ^ (h >> 33)) * 0xff51afd7ed558ccdull;
+            h = (h ^ (h >> 33)) * 0xc4ceb9fe1a85ec53ull;
+            return h ^ (h >> 33);
+        }
+
+        [[nodiscard]] size_t slot(uint64_t h, uint32_t displacement) const {
+            const uint64_t f1 = h >> 32, f2 = (h & 0xffffffffu) | 1;
+            return (f1 + displacement * f2) & (slots_.size() - 1);
+        }
+
+        bool try_build(const std::pmr::vector<std::pair<std::string_view, T>> &keys) {
+            size_t n_slots = 1;
+            while (n_slots < keys.size() * 2)
+                n_slots *= 2;
+            slots_.assign(n_slots, {std::string_view(), T{}});
+            displacements_.assign(std::max<size_t>(1, keys.size() / 2), 0);
+
+            std::pmr::vector<std::pmr::vector<size_t>> buckets(displacements_.size(), slots_.get_allocator());
+            for (size_t i = 0; i < keys.size(); i++)
+                buckets[hash(keys[i].first, seed_) % buckets.size()].emplace_back(i);
+            std::pmr::vector<size_t> order(buckets.size(), slots_.get_allocator());
+            for (size_t b = 0; b < order.size(); b++)
+                order[b] = b;
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); });   // place the largest buckets first
+
+            std::pmr::vector<size_t> placed(slots_.get_allocator());
+            for (const size_t b : order) {
+                bool ok = buckets[b].empty();
+                for (uint32_t d = 0; !ok && d < 4096; d++) {
+                    placed.clear();
+                    ok = true;
+                    for (const size_t i : buckets[b]) {
+                        const size_t s = slot(hash(keys[i].first, seed_), d);
+                        if (slots_[s].first.data() != nullptr || std::find(placed.begin(), placed.end(), s) != placed.end()) {
+                            ok = false;
+                            break;
+                        }
+                        placed.emplace_back(s);
+                    }
+                    if (ok) {
+                        displacements_[b] = d;
+                        for (size_t k = 0; k < placed.size(); k++)
+                            slots_[placed[k]] = keys[buckets[b][k]];
+                    }
+                }
+                if (!ok)
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    /* A file mapped privately into memory, such that it can be modified in-place without affecting the file (only the pages that are written to are copied).
+     * Falls back to reading the file into a buffer on Windows
+     */
+    class MappedFile {
+    public:
+        explicit MappedFile(const char *path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        [[nodiscard]] bool is_open() const { return is_open_; }
+        [[nodiscard]] char *data() { return data_; }
+        [[nodiscard]] size_t size() const { return size_; }
+
+    private:
+        char *data_ = nullptr;
+        size_t size_ = 0;
+        bool is_open_ = false;
+#ifdef _WIN32
+        std::string buffer_;
+#endif
+    };
+
+    char **environment();                           // the environment of the process, as "NAME=VALUE" strings
+
+    // Checks of paths used by Entry::must_exist, Entry::readable and Entry::writable_dir, which may be called from any thread
+    bool path_exists(std::string_view path);
+    bool path_readable(std::string_view path);
+    bool is_writable_dir(std::string_view path);
+
+    long read_descriptor(int fd, char *data, size_t size);     // like ::read, retried when interrupted by a signal
+
+    /* Split the contents of a response file into arguments in a single pass, calling `f(token, is_quoted)` with views into `data`.
+     * Arguments are separated by whitespace, which can be preserved using single or double quotes or by escaping with a backslash (escaping is not applied within single quotes).
+     * Quotes and escapes are removed in-place, therefore `data` is modified.
+     */
+    template <typename F> void tokenize_response_file(char *data, size_t size, F &&f) {
+        char *r = data, *const end = data + size;
+        while (r != end) {
+            if (std::isspace((unsigned char)*r)) {
+                ++r;
+                continue;
+            }
+            char *const start = r, *w = r;
+            char quote = '\0';
+            bool has_quotes = *r == '\\';
+            for (; r != end && (quote != '\0' || !std::isspace((unsigned char)*r)); ++r) {
+                char c = *r;
+                if (quote != '\'' && c == '\\' && r + 1 != end) {
+                    c = *++r;
+                } else if (quote == '\0' && (c == '"' || c == '\'')) {
+                    quote = c;
+                    has_quotes = true;
+                    continue;
+                } else if (c == quote) {
+                    quote = '\0';
+                    continue;
+                }
+                if (w != r)     // only write (and thereby copy the page) when quotes or escapes were removed
+                    *w = c;
+                ++w;
+            }
+            f(std::string_view(start, w - start), has_quotes);
+        }
+    }
+
+    /* Parse an INI-style configuration file in a single pass, calling `f(section, key, value)` with views into `data` for each `key = value` line.
+     * Lines starting with '#' or ';' are comments, `[section]` starts a section. Surrounding whitespace, and quotes around a value, are removed
+     */
+    template <typename F> void parse_config_file(const char *data, size_t size, F &&f) {
+        auto trim = [](std::string_view v) {
+            while (!v.empty() && std::isspace((unsigned char)v.front()))
+                v.remove_prefix(1);
+            while (!v.empty() && std::isspace((unsigned char)v.back()))
+                v.remove_suffix(1);
+            return v;
+        };
+        const std::string_view contents(data, size);
+        std::string_view section;
+        for (size_t start = 0; start < contents.size();) {
+            const size_t end = std::min(contents.find('\n', start), contents.size());
+            const std::string_view line = trim(contents.substr(start, end - start));
+            start = end + 1;
+            if (line.empty() || line[0] == '#' || line[0] == ';')
+                continue;
+            if (line[0] == '[' && line.back() == ']') {
+                section = trim(line.substr(1, line.size() - 2));
+                continue;
+            }
+            const size_t eq_idx = line.find('=');
+            if (eq_idx == std::string_view::npos)
+                continue;
+            std::string_view value = trim(line.substr(eq_idx + 1));
+            if (value.size() > 1 && (value[0] == '"' || value[0] == '\'') && value.back() == value[0])
+                value = value.substr(1, value.size() - 2);
+            f(section, trim(line.substr(0, eq_idx)), value);
+        }
+    }
+
+    // The file descriptor of a value that is streamed: `-` for stdin and `@fd:N` for descriptor N, or -1 for all other values
+    inline int stream_descriptor(std::string_view value) {
+        if (value == "-")
+            return 0;
+        constexpr std::string_view prefix = "@fd:";
+        if (value.size() <= prefix.size() || value.substr(0, prefix.size()) != prefix)
+            return -1;
+        int fd = -1;
+        const char *last = value.data() + value.size();
+        return std::from_chars(value.data() + prefix.size(), last, fd).ptr == last && fd >= 0? fd : -1;
+    }
+
+    /* Read a list from file descriptor `fd` in chunks, calling `f(element)` for each element, which returns false to stop.
+     * Elements are separated by ',' or whitespace. Only a single chunk is held in memory, plus the part of an element that crosses its end.
+     * Returns false when the descriptor could not be read
+     */
+    template <typename F> bool stream_elements(int fd, std::pmr::memory_resource *resource, F &&f, size_t chunk_size = 64 * 1024) {
+        std::pmr::vector<char> chunk(chunk_size, resource);
+        std::pmr::string pending(resource);     // an element that crosses the end of a chunk
+        auto is_separator = [](char c) { return c == ',' || std::isspace((unsigned char)c); };
+        while (true) {
+            const long n = read_descriptor(fd, chunk.data(), chunk.size());
+            if (n < 0)
+                return false;
+            if (n == 0)
+                break;
+            size_t start = 0;
+            for (size_t i = 0; i < size_t(n); i++) {
+                if (!is_separator(chunk[i]))
+                    continue;
+                const std::string_view part(chunk.data() + start, i - start);
+                start = i + 1;
+                if (!pending.empty()) {
+                    pending.append(part);
+                    if (!f(std::string_view(pending)))
+                        return true;
+                    pending.clear();
+                } else if (!part.empty() && !f(part)) {
+                    return true;
+                }
+            }
+            pending.append(chunk.data() + start, size_t(n) - start);
+        }
+        if (!pending.empty())
+            f(std::string_view(pending));
+        return true;
+    }
+
+    // Interns strings into blocks allocated from a memory resource. Equal strings are stored only once, and views into the pool remain valid for the lifetime of the pool
+    class StringPool {
+    public:
+        explicit StringPool(std::pmr::memory_resource *resource) : resource_(resource), strings_(resource), blocks_(resource) {}
+        ~StringPool() {
+            for (const auto &[block, size] : blocks_)
+                resource_->deallocate(block, size, 1);
+        }
+
+        StringPool(const StringPool &) = delete;
+        StringPool &operator=(const StringPool &) = delete;
+
+        std::string_view intern(std::string_view str) {
+            auto it = strings_.find(str);
+            if (it != strings_.end())
+                return *it;
+            if (str.size() > remaining_) {
+                const size_t size = std::max(block_size, str.size());
+                current_ = (char *)resource_->allocate(size, 1);
+                remaining_ = size;
+                blocks_.emplace_back(current_, size);
+            }
+            const std::string_view interned(current_, str.size());
+            std::copy(str.begin(), str.end(), current_);
+            current_ += str.size();
+            remaining_ -= str.size();
+            return *strings_.emplace(interned).first;
+        }
+
+    private:
+        static constexpr size_t block_size = 4096;
+        std::pmr::memory_resource *resource_;
+        std::pmr::unordered_set<std::string_view> strings_;
+        std::pmr::vector<std::pair<char*, size_t>> blocks_;
+        char *current_ = nullptr;
+        size_t remaining_ = 0;
+    };
+
+    /* Prefix trie over a set of keys, used to answer completion queries. The children of a node are kept in a sorted sibling list,
+     * such that all keys starting with a prefix are visited in lexicographic order. The keys need to outlive the trie
+     */
+    class PrefixTrie {
+    public:
+        explicit PrefixTrie(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) : nodes_(1, Node(), resource) {}
+
+        void insert(std::string_view key) {
+            uint32_t node = 0;
+            for (const char c : key) {
+                const uint32_t next = *find_link(node, c);
+                if (next != 0 && nodes_[next].c == c) {
+                    node = next;
+                } else {
+                    const auto child = (uint32_t)nodes_.size();
+                    nodes_.push_back({c, 0, next, {}, false});
+                    *find_link(node, c) = child;     // found again, as the push may have moved the nodes
+                    node = child;
+                }
+            }
+            nodes_[node].key = key;
+            nodes_[node].is_key = true;
+        }
+
+        // Call f for each key that starts with `prefix`
+        template <typename F> void complete(std::string_view prefix, F &&f) const {
+            uint32_t node = 0;
+            for (const char c : prefix) {
+                node = nodes_[node].first_child;
+                while (node != 0 && nodes_[node].c != c)
+                    node = nodes_[node].next_sibling;
+                if (node == 0)
+                    return;
+            }
+            visit(node, f);
+        }
+
+    private:
+        struct Node {
+            char c = 0;
+            uint32_t first_child = 0, next_sibling = 0;   // 0 is the root, which is never a child
+            std::string_view key;
+            bool is_key = false;
+        };
+        std::pmr::vector<Node> nodes_;
+
+        // The link that should point to the child `c` of `node`, to keep the siblings sorted
+        uint32_t *find_link(uint32_t node, char c) {
+            uint32_t *link = &nodes_[node].first_child;
+            while (*link != 0 && nodes_[*link].c < c)
+                link = &nodes_[*link].next_sibling;
+            return link;
+        }
+
+        template <typename F> void visit(uint32_t node, F &f) const {
+            if (nodes_[node].is_key)
+                f(nodes_[node].key);
+            for (uint32_t child = nodes_[node].first_child; child != 0; child = nodes_[child].next_sibling)
+                visit(child, f);
+        }
+    };
+
+    // Fields of an entry that are needed while parsing, kept small such that the table of entries stays compact
+    struct EntryInfo {
+        std::optional<std::string_view> implicit_value;
+        Entry::ARG_TYPE type;
+        bool is_multi_argument = false;
+        bool is_reloadable = false;     // takes new values on a reload, see Reloadable
+    };
+
+    // Fields of an entry that are only needed for defaults, help and error messages
+    struct EntryMeta {
+        std::string_view help;
+        std::optional<std::string_view> default_str;    // defaults given as text, the text of typed defaults (in Schema::data_defaults) is only formatted for help and print
+        std::string_view env_name;              // empty when not backed by an environment variable
+        uint32_t first_key = 0, n_keys = 0;     // range in Schema::keys
+    };
+
+    // Where the value of an entry comes from, in order of precedence
+    enum class Source : uint8_t {COMMANDLINE, ENVIRONMENT, CONFIG_FILE, DEFAULT};
+
+    // State of an entry, reset for each parse
+    struct EntryState {
+        std::optional<std::string_view> value;  // view into argv, a response file, the environment, a config file or the string pool
+        bool has_values = false;                // whether ParseState::values contains the values of this entry
+        Source source = Source::COMMANDLINE;
+    };
+
+    // A check of the values of an entry (see Entry::satisfies), the checks of an entry are contiguous in Schema::checks
+    struct ValueCheck {
+        uint32_t entry;
+        std::function<bool(std::string_view value)> predicate;
+        std::string_view message;
+    };
+
+    /* All declared entries in contiguous tables, indexed by the entry index.
+     * A schema is built by the declarations of an Args object and becomes immutable once compiled (see `Args::compile`),
+     * after which it can be shared between any number of Args objects and threads.
+     */
+    struct Schema {
+        explicit Schema(std::pmr::memory_resource *resource) :
+                strings(resource), info(resource), meta(resource), keys(resource), data_defaults(resource),
+                arg_entries(resource), kwarg_entries(resource), kwarg_index(resource), env_entries(resource), env_index(resource),
+                subcommands(resource), subcommand_entries(resource), subcommand_index(resource), checks(resource) {
+        }
+
+        StringPool strings;                                   // all keys, help texts and default strings
+        std::pmr::vector<EntryInfo> info;                     // hot
+        std::pmr::vector<EntryMeta> meta;                     // cold
+        std::pmr::vector<std::string_view> keys;
+        std::pmr::vector<ConvertPtr> data_defaults;
+        std::pmr::vector<uint32_t> arg_entries;
+        std::pmr::map<std::string_view, uint32_t, std::less<>> kwarg_entries;
+        KeyIndex<uint32_t> kwarg_index;                       // frozen lookup table of kwarg_entries, built when compiling
+        std::pmr::map<std::string_view, uint32_t, std::less<>> env_entries;  // environment variable name -> entry
+        KeyIndex<uint32_t> env_index;
+        std::pmr::vector<std::pair<std::string_view, std::string_view>> subcommands;    // name and help of each subcommand, its entries are only declared when selected
+        std::pmr::map<std::string_view, uint32_t, std::less<>> subcommand_entries;
+        KeyIndex<uint32_t> subcommand_index;
+        std::pmr::vector<ValueCheck> checks;                   // in order of the entries
+        uint32_t help_index = 0;
+        std::optional<uint32_t> config_index;               // the entry holding the path of the configuration file
+        bool is_compiled = false;
+    };
+
+    // Holds the Args of a subcommand, which is only constructed when the subcommand is selected
+    struct SubcommandBase {
+        virtual ~SubcommandBase() = default;
+        virtual Args &create(std::pmr::memory_resource *resource) = 0;
+        virtual void reset() = 0;
+    };
+
+    // The kind of a parse error, of which the message is only formatted when requested (see `format_error`)
+    enum class ErrorKind : uint8_t {
+        INVALID_VALUE,          // the value could not be converted
+        OUT_OF_RANGE,           // the value is a number that does not fit in the type
+        CONVERSION_FAILED,      // the conversion threw an exception, of which the message is kept as detail
+        MISSING_VALUE,          // a key that requires a value is not followed by one
+        MISSING_ARGUMENT,       // a required entry was not given
+        UNKNOWN_COMMAND,        // the first positional argument is not a subcommand
+        UNREADABLE_FILE,        // the configuration file could not be read
+        UNREADABLE_STREAM,      // the values could not be read from stdin or a file descriptor
+        FAILED_CHECK,           // the value failed a check of the entry (e.g. Entry::must_exist), of which the message is kept as detail
+        UNRECOGNISED_KEY,       // a key that is not declared, only recorded by `check` (parsing prints a warning). The path of a configuration file is kept as detail
+    };
+
+    struct ParseError {
+        static constexpr uint32_t no_token = ~0u;
+        static constexpr size_t no_offset = ~size_t(0);
+
+        uint32_t entry = 0;
+        ErrorKind kind = ErrorKind::INVALID_VALUE;
+        uint32_t token = no_token;      // index in the tokenized commandline (without the program name), or no_token for values from elsewhere
+        std::pmr::string value;         // the value, key, command or path the error is about
+        std::pmr::string detail;        // the message of a failed conversion
+        size_t offset = no_offset;      // the offset in `value` of the element of a list that failed to convert
+    };
+
+    // Forwards all allocations to `upstream`, and counts them
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        explicit CountingResource(std::pmr::memory_resource *upstream) : upstream_(upstream) {}
+
+        [[nodiscard]] size_t allocations() const { return allocations_; }
+        [[nodiscard]] size_t bytes() const { return bytes_; }
+
+    private:
+        std::pmr::memory_resource *upstream_;
+        size_t allocations_ = 0, bytes_ = 0;
+
+        void *do_allocate(size_t bytes, size_t alignment) override {
+            allocations_++;
+            bytes_ += bytes;
+            return upstream_->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+            upstream_->deallocate(p, bytes, alignment);
+        }
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    /* Time and allocations of the last parse, collected when enabled with Args::collect_stats() or the ARGPARSE_STATS environment variable.
+     * Conversions of values are attributed to CONVERT (and to the entry that was converted), the other phases exclude them
+     */
+    struct ParseStats {
+        enum Phase : uint8_t {TOKENIZE, LOOKUP, CONVERT, ENVIRONMENT, CONFIG_FILE, DEFAULTS, VALIDATE, N_PHASES};
+        static constexpr std::array<std::string_view, N_PHASES> phase_names = {"tokenize", "key lookup", "convert", "environment", "config file", "defaults", "validate"};
+
+        struct Counters {
+            uint64_t ns = 0;
+            size_t allocations = 0, bytes = 0;
+
+            Counters &operator+=(const Counters &other) {
+                ns += other.ns;
+                allocations += other.allocations;
+                bytes += other.bytes;
+                return *this;
+            }
+        };
+
+        explicit ParseStats(std::pmr::memory_resource *resource) : entries(resource) {}
+
+        bool enabled = false;
+        std::array<Counters, N_PHASES> phases{};
+        std::pmr::vector<Counters> entries;     // the conversions of each entry
+
+        // start of the current phase, and the conversions within it
+        std::chrono::steady_clock::time_point mark;
+        Counters mark_allocations, converted;
+    };
+
+    // Everything that is produced by parsing a commandline, which is reused (including its capacity) for the next parse
+    struct ParseState {
+        explicit ParseState(std::pmr::memory_resource *upstream) :
+                counter(upstream), converters(&counter), state(&counter), values(&counter), errors(&counter), program_name(&counter), config_path(&counter), params(&counter), token_order(&counter),
+                arguments_flat(&counter), response_files(&counter), subcommands(upstream), stats(upstream) {
+        }
+
+        CountingResource counter;                           // all allocations of a parse, declared first as it needs to outlive the other members
+        std::pmr::vector<ConvertPtr> converters;              // converter slot of each entry, holds the data the user references point to
+        std::pmr::vector<EntryState> state;
+        std::pmr::vector<std::pair<uint32_t, std::string_view>> values;    // all values for multi-arguments and repeated keys, only used for printing
+        std::pmr::vector<ParseError> errors;
+        std::pmr::string program_name;                      // including the names of the parent commands for subcommands
+        std::pmr::string config_path;                       // the configuration file that was read, if any
+        std::pmr::vector<std::string_view> params;            // views into the original argv buffers (or response files), no copies are made while tokenizing
+        std::pmr::vector<uint32_t> token_order;               // indices of params ordered by address, built on the first error (see Args::_token_index)
+        std::pmr::vector<std::string_view> arguments_flat;
+        std::pmr::vector<std::shared_ptr<MappedFile>> response_files;  // response and configuration files, kept alive as the values are views into them
+        std::pmr::vector<std::unique_ptr<SubcommandBase, ResourceDeleter>> subcommands;
+        std::optional<uint32_t> selected_subcommand;
+        bool check_only = false;                            // collect the errors, without streaming values, printing help, exiting or throwing
+        bool collect_stats = false;
+        size_t check_threads = 8;                           // the maximum number of threads that run the checks of the values
+        ParseStats stats;
+    };
+
+    inline constexpr size_t max_response_file_depth = 16;
+
+    /* Add a commandline token to `params`, where `@path` is replaced by the arguments in the response file at `path`, which may refer to other response files in turn.
+     * In case the file cannot be read, the token is used as-is (like gcc does). Opened files are kept alive in `files`, as the params are views into them
+     */
+    inline void add_commandline_token(std::string_view token, std::pmr::vector<std::string_view> &params, std::pmr::vector<std::shared_ptr<MappedFile>> &files, const size_t depth = 0) {
+        if (token.size() > 1 && token[0] == '@' && depth < max_response_file_depth && stream_descriptor(token) < 0) {   // `@fd:N` is a streamed value
+            std::pmr::memory_resource *resource = params.get_allocator().resource();
+            const std::pmr::string path(token.substr(1), resource);
+            auto file = std::allocate_shared<MappedFile>(std::pmr::polymorphic_allocator<MappedFile>(resource), path.c_str());
+            if (file->is_open()) {
+                tokenize_response_file(file->data(), file->size(), [&](std::string_view t, bool is_quoted) {
+                    is_quoted? (void)params.emplace_back(t) : add_commandline_token(t, params, files, depth + 1);
+                });
+                files.emplace_back(std::move(file));
+                return;
+            }
+        }
+        params.emplace_back(token);
+    }
+
+    // The quoted value of an error, e.g. "1,x" or "x" at offset 2 of "1,x" when an element of a list failed to convert
+    inline std::string quote_value(std::string_view value, size_t offset) {
+        const std::string_view element = offset < value.size()? list_element(value, offset) : value;
+        std::string quoted = "\"" + std::string(element) + "\"";
+        if (element.size() != value.size())
+            quoted.append(" at offset ").append(std::to_string(offset)).append(" of \"").append(value).append("\"");
+        return quoted;
+    }
+
+    // The message of an error, where `describe` describes the entry (its keys and help)
+    inline std::string format_error(ErrorKind kind, std::string_view value, const std::string &describe, std::string_view detail, size_t offset = ParseError::no_offset) {
+        switch (kind) {
+            case ErrorKind::INVALID_VALUE: return "Invalid argument, could not convert " + quote_value(value, offset) + " for " + describe;
+            case ErrorKind::OUT_OF_RANGE: return "Invalid argument " + quote_value(value, offset) + " for " + describe + ". Error: out of range";
+            case ErrorKind::CONVERSION_FAILED: return "Invalid argument " + quote_value(value, offset) + " for " + describe + ". Error: " + std::string(detail);
+            case ErrorKind::MISSING_VALUE: return "No value provided for: " + std::string(value);
+            case ErrorKind::MISSING_ARGUMENT: return "Argument missing: " + describe;
+            case ErrorKind::UNKNOWN_COMMAND: return "Unknown command: " + std::string(value);
+            case ErrorKind::UNREADABLE_FILE: return "Could not read configuration file \"" + std::string(value) + "\" for " + describe;
+            case ErrorKind::UNREADABLE_STREAM: return "Could not read the values for " + describe + " from file descriptor " + std::to_string(stream_descriptor(value));
+            case ErrorKind::FAILED_CHECK: return "Invalid argument " + quote_value(value, offset) + " for " + describe + ": " + std::string(detail);
+            case ErrorKind::UNRECOGNISED_KEY:
+                if (detail.empty())
+                    return "unrecognised commandline argument: " + std::string(value);
+                return "unrecognised key in configuration file " + std::string(detail) + ": " + std::string(value);
+        }
+        return {};
+    }
+
+    // Run `convert`, and return the kind of error if it failed, where `detail` receives the message of a thrown exception
+    template <typename F> std::optional<ErrorKind> conversion_error_kind(F &&convert, std::string &detail) {
+        std::errc ec;
+        try {
+            ec = convert();
+        } catch (const std::invalid_argument &e) {
+            ec = std::errc::invalid_argument;
+        } catch (const std::runtime_error &e) {
+            detail = e.what();
+            return ErrorKind::CONVERSION_FAILED;
+        }
+        if (ec == std::errc::invalid_argument)
+            return ErrorKind::INVALID_VALUE;
+        else if (ec == std::errc::result_out_of_range)
+            return ErrorKind::OUT_OF_RANGE;
+        return std::nullopt;
+    }
+
+    /* Run `convert` on `value`, and return the error message (or an empty string on success), where `describe()` describes the entry
+     * and `offset` is the offset of the bad element of a list, as set by `convert`
+     */
+    template <typename F, typename D> std::string conversion_error(std::string_view value, D &&describe, F &&convert, const size_t &offset = ParseError::no_offset) {
+        std::string detail;
+        const std::optional<ErrorKind> kind = conversion_error_kind(convert, detail);
+        return kind.has_value()? format_error(*kind, value, describe(), detail, offset) : std::string();
+    }
+
+    // The keys of entry i, e.g. "-k,--key" (or "arg_0" for positional arguments)
+    inline std::string entry_keys(const Schema &schema, uint32_t i) {
+        const EntryMeta &meta = schema.meta[i];
+        std::string keys;
+        for (uint32_t k = 0; k < meta.n_keys; k++) {
+            const std::string_view key = schema.keys[meta.first_key + k];
+            keys.append(k? "," : "").append(schema.info[i].type == Entry::ARG? "" : (key.size() > 1 ? "--" : "-")).append(key);
+        }
+        return keys;
+    }
+
+    inline std::string describe_entry(const Schema &schema, uint32_t i) {
+        return entry_keys(schema, i) + " (" + std::string(schema.meta[i].help) + ")";
+    }
+
+    inline std::string format_error(const Schema &schema, const ParseError &error) {
+        return format_error(error.kind, error.value, describe_entry(schema, error.entry), error.detail, error.offset);
+    }
+
+    // Output of help texts and errors, defined together with the parser (as it is compiled only once in compiled-library mode)
+    void print_text(std::string_view text);
+    void print_warning(std::string_view text);                          // to stderr, e.g. unrecognised arguments
+    void report_error(const std::string &error, bool raise_on_error);   // throws, or prints the error and exits
+
+    /* Walk over the tokens of a commandline, and resolve the keys (`--key value`, `--key=value`, `-k`, clusters of flags `-abc`) through handler `h`:
+     *   const EntryInfo *h.find(key, index)                  the entry of a key (and its index), or nullptr if unknown
+     *   h.convert(index, value) / h.convert(index, first, last)   a value, or the values of a multi-argument
+     *   h.missing_value(index, key), h.unrecognised(key)
+     *   bool h.positional(token)                              all tokens that are not keys or their values, returns false to stop
+     * Returns the number of tokens that were scanned
+     */
+    template <typename H> size_t scan_commandline(const std::string_view *params, size_t n, H &h) {
+        auto is_value = [&](const size_t &i) -> bool {
+            return n > i && (params[i].empty() || params[i][0] != '-' || params[i].size() == 1 || std::isdigit(params[i][1]));  // check for number to not accidentally mark negative numbers as non-parameter, a single '-' is stdin
+        };
+        auto parse_param = [&](size_t &i, std::string_view key, const bool is_short, const std::optional<std::string_view> &equal_value=std::nullopt) {
+            uint32_t index = 0;
+            const EntryInfo *entry = h.find(key, index);
+            if (entry == nullptr) {
+                h.unrecognised(key);
+            } else if (equal_value.has_value()) {
+                h.convert(index, equal_value.value());
+            } else if (entry->implicit_value.has_value()) {
+                h.convert(index, *entry->implicit_value);
+            } else if (!is_short) { // short values are not allowed to look ahead for the next parameter
+                if (is_value(i + 1)) {
+                    if (entry->is_multi_argument) {
+                        const size_t first = ++i;
+                        while (is_value(i + 1))
+                            ++i;
+                        h.convert(index, &params[first], &params[i] + 1);
                     } else {
-                        entry->error = "No value provided for: " + key;
+                        h.convert(index, params[++i]);
                     }
+                } else if (entry->is_multi_argument) {
+                    h.convert(index, nullptr, nullptr);    // for multiargument parameters, return an empty vector when not passing any more values
                 } else {
+                    h.missing_value(index, key);
+                }
+            } else {
+                h.missing_value(index, key);
+            }
+        };
+        auto add_param = [&](size_t &i, const size_t &start) {
+            size_t eq_idx = params[i].find('=');  // check if value was passed using the '=' sign
+            if (eq_idx != std::string_view::npos) { // key/value from = notation
+                parse_param(i, params[i].substr(start, eq_idx - start), false, params[i].substr(eq_idx + 1));
+            } else {
+                parse_param(i, params[i].substr(start), false);
+            }
+        };
+
+        for (size_t i = 0; i < n; i++) {
+            if (!is_value(i)) {
+                if (params[i].size() > 1 && params[i][1] == '-') {  // long --
+                    add_param(i, 2);
+                } else { // short -
+                    const size_t j_end = std::min(params[i].size(), params[i].find('=')) - 1;
+                    for (size_t j = 1; j < j_end; j++) { // add possible other flags
+                        parse_param(i, params[i].substr(j, 1), true);
+                    }
+                    add_param(i, j_end);
+                }
+            } else if (!h.positional(params[i])) {
+                return i + 1;
+            }
+        }
+        return n;
+    }
+
+    /* Distribute the positional values over the `n_entries` positional entries, making sure multi_argument positional arguments are processed last
+     * to enable arguments afterwards. Uses handler `h`: h.is_multi_argument(a), h.convert_positional(a, value) and h.convert_positional(a, first, last)
+     */
+    template <typename H> void assign_positionals(size_t n_entries, const std::string_view *values, size_t n_values, H &h) {
+        size_t arg_i = 0;
+        for (; arg_i < n_entries && !h.is_multi_argument(arg_i); arg_i++) { // iterate over positional arguments until a multi-argument is found
+            if (arg_i < n_values)
+                h.convert_positional(arg_i, values[arg_i]);
+        }
+        size_t arg_j = 1;
+        for (size_t j_end = n_entries - arg_i; arg_j <= j_end; arg_j++) { // iterate from back to front, to ensure non-multi-arguments in the front and back are given preference
+            size_t flat_idx = n_values - arg_j;
+            if (flat_idx < n_values && flat_idx >= arg_i) {
+                if (h.is_multi_argument(n_entries - arg_j)) {
+                    h.convert_positional(arg_i, &values[arg_i], &values[flat_idx] + 1);   // append all remaining arguments directly
+                } else {
+                    h.convert_positional(n_entries - arg_j, values[flat_idx]);
+                }
+            }
+        }
+    }
+
+    class Args {
+    private:
+        std::pmr::memory_resource *resource;    // all allocations of the parser come from this resource
+        std::shared_ptr<const Schema> schema;
+        Schema *declaring = nullptr;            // the schema while it is being declared, nullptr once compiled or when using a shared schema
+        uint32_t n_declared = 0;                // number of declarations seen when using a shared schema
+        uint32_t n_subcommands = 0;             // number of subcommands declared by this object
+        std::shared_ptr<ParseState> state;      // shared between copies of Args, such that their references point to the same data
+
+        Entry add_entry(Entry::ARG_TYPE type, std::string_view key, std::string_view help, std::optional<std::string_view> implicit_value=std::nullopt) {
+            if (declaring == nullptr) {     // using a compiled schema, which already contains this declaration
+                if (n_declared >= schema->info.size() || schema->info[n_declared].type != type)
+                    throw std::logic_error("argparse: the declared arguments do not match the schema");
+                return {*this, n_declared++};
+            }
+            Schema &s = *declaring;
+            const auto index = (uint32_t)s.info.size();
+            EntryMeta &meta = s.meta.emplace_back();
+            meta.help = s.strings.intern(help);
+            meta.first_key = (uint32_t)s.keys.size();
+            for_each_split(key, [&](std::string_view k) { s.keys.emplace_back(s.strings.intern(k)); });
+            meta.n_keys = (uint32_t)s.keys.size() - meta.first_key;
+            s.info.push_back({implicit_value.has_value()? std::optional(s.strings.intern(*implicit_value)) : std::nullopt, type});
+            s.data_defaults.emplace_back();
+            if (type == Entry::ARG) {
+                s.arg_entries.emplace_back(index);
+            } else {
+                for (uint32_t k = 0; k < meta.n_keys; k++)
+                    s.kwarg_entries[s.keys[meta.first_key + k]] = index;
+            }
+            return {*this, index};
+        }
+
+        [[nodiscard]] std::string _get_keys(uint32_t i) const {
+            return entry_keys(*schema, i);
+        }
+
+        [[nodiscard]] std::string _describe(uint32_t i) const {
+            return describe_entry(*schema, i);
+        }
+
+        /* The index of the commandline token that `value` is a view into, or ParseError::no_token.
+         * The tokens do not overlap, so they are ordered by address once (on the first error of a parse) and each lookup is a binary search
+         */
+        [[nodiscard]] uint32_t _token_index(std::string_view value) const {
+            ParseState &s = *state;
+            const std::less<const char*> less;
+            if (s.token_order.size() != s.params.size()) {
+                s.token_order.resize(s.params.size());
+                for (uint32_t k = 0; k < s.params.size(); k++)
+                    s.token_order[k] = k;
+                if (!std::is_sorted(s.params.begin(), s.params.end(), [&](std::string_view a, std::string_view b) { return less(a.data(), b.data()); }))    // argv is usually in address order already
+                    std::sort(s.token_order.begin(), s.token_order.end(), [&](uint32_t a, uint32_t b) { return less(s.params[a].data(), s.params[b].data()); });
+            }
+            const auto after = std::upper_bound(s.token_order.begin(), s.token_order.end(), value.data(), [&](const char *p, uint32_t k) { return less(p, s.params[k].data()); });
+            if (after == s.token_order.begin())
+                return ParseError::no_token;
+            const std::string_view token = s.params[*(after - 1)];
+            if (less(token.data() + token.size(), value.data() + value.size()))
+                return ParseError::no_token;
+            return *(after - 1);
+        }
+
+        // Record an error, of which the message is only formatted when it is reported
+        void _set_error(uint32_t i, ErrorKind kind, std::string_view value = {}, std::string_view detail = {}, size_t offset = ParseError::no_offset) {
+            ParseError &error = state->errors.emplace_back();
+            error.entry = i;
+            error.kind = kind;
+            error.token = _token_index(value);
+            error.value = value;
+            error.detail = detail;
+            error.offset = offset;
+        }
+
+        template <typename F> void _try_convert(uint32_t i, std::string_view value, F &&convert, const size_t &offset = ParseError::no_offset) {
+            std::string detail;
+            const std::optional<ErrorKind> kind = conversion_error_kind(convert, detail);
+            if (kind.has_value())
+                _set_error(i, *kind, value, detail, offset);
+        }
+
+        // Keep track of all values when an entry receives more than one, such that they can be printed
+        void _add_value(uint32_t i, std::string_view value) {
+            EntryState &entry = state->state[i];
+            if (entry.value.has_value()) {
+                if (!entry.has_values)
+                    state->values.emplace_back(i, *entry.value);
+                state->values.emplace_back(i, value);
+                entry.has_values = true;
+            }
+            entry.value = value;
+        }
+
+        // A repeated key (e.g. `-I a -I b`) appends to vectors instead of replacing them
+        void _convert(uint32_t i, std::string_view value) {
+            const bool repeated = state->state[i].value.has_value();
+            ConvertBase &data = *state->converters[i];
+            _add_value(i, value);
+            _measure(i, [&]() {
+                const int fd = state->state[i].source == Source::COMMANDLINE? stream_descriptor(value) : -1;   // only values on the commandline are streamed
+                if (fd >= 0 && data.is_streamable() && !state->check_only) {
+                    _stream(i, value, fd, repeated);
+                } else {
+                    size_t offset = ParseError::no_offset;
+                    _try_convert(i, value, [&]() { return repeated? data.append_list(value, &offset) : data.convert(value, &offset); }, offset);
+                }
+            });
+        }
+
+        // Convert the elements of a vector that are streamed from stdin (`-`) or a file descriptor (`@fd:N`) one by one, without reading them into a single string
+        void _stream(uint32_t i, std::string_view value, int fd, bool repeated) {
+            ConvertBase &data = *state->converters[i];
+            if (!repeated)
+                data.clear();
+            const size_t n_errors = state->errors.size();
+            const bool is_read = stream_elements(fd, &state->counter, [&](std::string_view element) {
+                _try_convert(i, element, [&]() { return data.append(element); });
+                return state->errors.size() == n_errors;
+            });
+            if (state->errors.size() != n_errors)
+                state->errors.back().token = _token_index(value);   // the element itself is not a token
+            else if (!is_read)
+                _set_error(i, ErrorKind::UNREADABLE_STREAM, value);
+        }
+
+        // Append each value as a single element, used for multi-arguments
+        void _convert(uint32_t i, const std::string_view *first, const std::string_view *last) {
+            EntryState &entry = state->state[i];
+            ConvertBase &data = *state->converters[i];
+            if (!entry.value.has_value()) {
+                data.clear();
+                entry.value = first == last? std::string_view() : *first;
+            }
+            entry.has_values = true;
+            data.reserve(last - first);
+            reserve_more(state->values, last - first);
+            const size_t n_errors = state->errors.size();
+            _measure(i, [&]() {
+                for (; first != last && state->errors.size() == n_errors; ++first) {
+                    state->values.emplace_back(i, *first);
+                    _try_convert(i, *first, [&]() { return data.append(*first); });
+                }
+            });
+        }
+
+        [[nodiscard]] ParseStats::Counters _stats_since_mark() const {
+            const ParseStats &stats = state->stats;
+            return {uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - stats.mark).count()),
+                    state->counter.allocations() - stats.mark_allocations.allocations, state->counter.bytes() - stats.mark_allocations.bytes};
+        }
+
+        void _mark_stats() {
+            ParseStats &stats = state->stats;
+            stats.mark = std::chrono::steady_clock::now();
+            stats.mark_allocations = {0, state->counter.allocations(), state->counter.bytes()};
+        }
+
+        // Attribute the time and allocations since the end of the previous phase to `phase`, apart from the conversions within it
+        void _end_phase(ParseStats::Phase phase) {
+            ParseStats &stats = state->stats;
+            if (!stats.enabled)
+                return;
+            const ParseStats::Counters total = _stats_since_mark(), &converted = stats.converted;
+            stats.phases[phase] += {total.ns - std::min(total.ns, converted.ns), total.allocations - converted.allocations, total.bytes - converted.bytes};
+            stats.phases[ParseStats::CONVERT] += converted;
+            stats.converted = {};
+            _mark_stats();
+        }
+
+        // Run a conversion of entry i, and measure it when collecting statistics
+        template <typename F> void _measure(uint32_t i, F &&convert) {
+            ParseStats &stats = state->stats;
+            if (!stats.enabled) {
+                convert();
+                return;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            const size_t allocations = state->counter.allocations(), bytes = state->counter.bytes();
+            convert();
+            const ParseStats::Counters c = {uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()),
+                                            state->counter.allocations() - allocations, state->counter.bytes() - bytes};
+            stats.entries[i] += c;
+            stats.converted += c;
+        }
+
+        void _apply_default(uint32_t i) {
+            const EntryMeta &meta = schema->meta[i];
+            state->state[i].source = Source::DEFAULT;
+            if (schema->data_defaults[i] != nullptr) {
+                state->converters[i]->set_default(*schema->data_defaults[i]);
+            } else if (meta.default_str.has_value()) {   // in cases where a string is provided to the `set_default` function
+                _convert(i, *meta.default_str);
+            } else {
+                _set_error(i, ErrorKind::MISSING_ARGUMENT);
+            }
+        }
+
+        void _read_config_file(uint32_t config_entry);
+        void _check_values();
+        void _prepare();
+        void _parse(const bool &raise_on_error);    // parse the tokens in ParseState::params
+
+        // Append the default of entry i to `text`, typed defaults are formatted here instead of when they are declared. Returns false if there is no default
+        bool _append_default(std::string &text, uint32_t i) const {
+            if (const std::optional<std::string_view> &str = schema->meta[i].default_str)
+                text.append(*str);
+            else if (schema->data_defaults[i] != nullptr)
+                text.append(schema->data_defaults[i]->to_string());
+            else
+                return false;
+            return true;
+        }
+
+        void _append_info(std::string &text, uint32_t i) const {
+            const EntryMeta &meta = schema->meta[i];
+            const std::optional<std::string_view> &implicit = schema->info[i].implicit_value;
+            const std::string_view allowed_entries = state->converters[i]->get_allowed_entries();
+            text.append(" [");
+            if (!allowed_entries.empty())
+                text.append("allowed: <").append(allowed_entries.substr(0, allowed_entries.size() - 2)).append(">, ");
+            if (implicit.has_value())
+                text.append("implicit: \"").append(*implicit).append("\", ");
+            if (!meta.env_name.empty())
+                text.append("env: ").append(meta.env_name).append(", ");
+            const size_t size = text.size();
+            if (!_append_default(text.append("default: "), i))
+                text.replace(size, std::string::npos, "required");
+            text.append("]");
+        }
+
+        // Take the values of the entries that are not reloadable from `from`, which needs to outlive this object, and drop their errors (see Reloadable)
+        void _inherit(const Args &from) {
+            ParseState &s = *state;
+            const ParseState &f = *from.state;
+            auto is_inherited = [&](uint32_t i) { return !schema->info[i].is_reloadable; };
+            for (uint32_t i = 0; i < schema->info.size(); i++) {
+                if (is_inherited(i)) {
+                    s.converters[i]->set_default(*f.converters[i]);
+                    s.state[i] = f.state[i];
+                }
+            }
+            s.values.erase(std::remove_if(s.values.begin(), s.values.end(), [&](const auto &value) { return is_inherited(value.first); }), s.values.end());
+            for (const auto &value : f.values) {
+                if (is_inherited(value.first))
+                    s.values.emplace_back(value);
+            }
+            s.errors.erase(std::remove_if(s.errors.begin(), s.errors.end(), [&](const ParseError &error) { return is_inherited(error.entry); }), s.errors.end());
+        }
+
+        friend class Entry;
+        template <typename T> friend class Reloadable;
+
+    public:
+        /* resource : The memory resource used for all allocations of the parser, e.g. a std::pmr::monotonic_buffer_resource.
+         *            Derived classes can forward it with `using argparse::Args::Args;`
+         */
+        explicit Args(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) :
+                resource(resource),
+                state(std::allocate_shared<ParseState>(std::pmr::polymorphic_allocator<ParseState>(resource), resource)) {
+            auto s = std::allocate_shared<Schema>(std::pmr::polymorphic_allocator<Schema>(resource), resource);
+            declaring = s.get();
+            schema = std::move(s);
+        }
+
+        /* Use a schema that was compiled before by an Args object of the same type (see `argparse::compile<T>`), which makes the declarations
+         * of the derived class skip building the schema, and only allocate the data for the parsed values.
+         * The schema needs to be created from the same declarations, otherwise a std::logic_error is thrown.
+         */
+        explicit Args(std::shared_ptr<const Schema> compiled_schema, std::pmr::memory_resource *resource = std::pmr::get_default_resource()) :
+                resource(resource),
+                schema(std::move(compiled_schema)),
+                state(std::allocate_shared<ParseState>(std::pmr::polymorphic_allocator<ParseState>(resource), resource)) {
+            if (!schema->is_compiled)
+                throw std::logic_error("argparse: the schema needs to be compiled");
+        }
+        virtual ~Args() = default;
+
+        /* Add a positional argument, the order in which it is defined equals the order in which they are being read.
+         * help : Description of the variable
+         *
+         * Returns the Entry, which will collapse into the requested type in `Entry::operator T&()`
+         */
+        Entry arg(std::string_view help) {
+            char key[32] = "arg_";
+            return add_entry(Entry::ARG, std::string_view(key, std::to_chars(key + 4, key + sizeof(key), schema->arg_entries.size()).ptr - key), help);
+        }
+
+        /* Add a Key-Worded argument that takes a variable.
+         * key : A comma-separated string, e.g. "k,key", which denotes the short (-k) and long(--key) keys_
+         * help : Description of the variable
+         * implicit_value : Implicit values are used when no value is provided.
+         *
+         * Returns the Entry, which will collapse into the requested type in `Entry::operator T&()`
+         */
+        Entry kwarg(std::string_view key, std::string_view help, const std::optional<std::string_view>& implicit_value=std::nullopt) {
+            return add_entry(Entry::KWARG, key, help, implicit_value);
+        }
+
+        /* Add a flag which will be false by default.
+         * key : A comma-separated string, e.g. "k,key", which denotes the short (-k) and long(--key) keys_
+         * help : Description of the variable
+         *
+         * Returns the Entry like kwarg
+         */
+        Entry flag(std::string_view key, std::string_view help) {
+            return kwarg(key, help, "true").set_default<bool>(false);
+        }
+
+        /* Add a subcommand, which is selected by its `name` as the first positional argument, after which the remaining arguments are parsed by T
+         * (derived from argparse::Args). T is only constructed when it is selected, such that the other subcommands cost nothing.
+         * help : Description of the subcommand
+         *
+         * Returns a reference to the instance of T, which is nullptr when the subcommand is not selected
+         */
+        template <typename T> std::shared_ptr<T> &subcommand(std::string_view name, std::string_view help);
+
+        /* Finish the declarations: adds the help flag and builds the key index. After this, the schema is immutable and can be shared
+         * with other Args objects of the same type (on any thread) to parse without building the schema again.
+         * Called automatically by `parse`.
+         */
+        std::shared_ptr<const Schema> compile() {
+            if (declaring != nullptr) {
+                declaring->help_index = flag("help", "print help").index;
+                declaring->kwarg_index.build(declaring->kwarg_entries);
+                declaring->env_index.build(declaring->env_entries);
+                declaring->subcommand_index.build(declaring->subcommand_entries);
+                declaring->is_compiled = true;
+                declaring = nullptr;
+            }
+            return schema;
+        }
+
+        // Collect the time and allocations of each phase of the next parses (also enabled by setting the ARGPARSE_STATS environment variable)
+        void collect_stats(bool enable = true) {
+            state->collect_stats = enable;
+        }
+
+        /* The maximum number of threads that run the checks of the values (see Entry::must_exist), which are mostly waiting on the filesystem.
+         * A single thread runs them sequentially
+         */
+        void set_check_threads(size_t n_threads) {
+            state->check_threads = std::max<size_t>(n_threads, 1);
+        }
+
+        // The statistics of the last parse, when collected
+        [[nodiscard]] const ParseStats &stats() const {
+            return state->stats;
+        }
+
+        // A readable report of the statistics of the last parse, including the `n_slowest` entries by conversion time
+        [[nodiscard]] std::string stats_report(size_t n_slowest = 5) const;
+
+        // Clear the results of the previous parse, keeping the allocated memory
+        void reset() {
+            ParseState &s = *state;
+            s.state.assign(schema->info.size(), EntryState());
+            s.converters.resize(schema->info.size());
+            s.values.clear();
+            s.errors.clear();
+            s.params.clear();
+            s.token_order.clear();
+            s.arguments_flat.clear();
+            s.response_files.clear();
+            s.config_path.clear();
+            for (auto &subcommand : s.subcommands)
+                subcommand->reset();
+            s.selected_subcommand.reset();
+            s.stats.phases.fill({});
+            s.stats.entries.assign(schema->info.size(), {});
+            s.stats.converted = {};
+        }
+
+        virtual void welcome() {}       // Allow to overwrite the `welcome` function to add a welcome-message to the help output
+        virtual void help();
+
+        void validate(const bool &raise_on_error);
+
+        /* parse all parameters and also check for the help_flag which was set in this constructor
+         * Upon error, it will print the error and exit immediately.
+         * The parsed tokens are views into argv, which therefore needs to outlive this object (as is the case for the argv passed to main)
+         * May be called repeatedly, where each parse starts from a clean state.
+         */
+        void parse(int argc, const char* const *argv, const bool &raise_on_error);
+
+        /* Parse without validating: collects all errors instead of only reporting the first one, and never prints help, exits or throws.
+         * Unrecognised keys, of which parsing only prints a warning, are recorded as ErrorKind::UNRECOGNISED_KEY. Values are not streamed from stdin or file descriptors, and subcommands are not parsed. Returns the errors (see `errors()`)
+         */
+        const std::pmr::vector<ParseError> &check(int argc, const char* const *argv);
+
+        // The errors of the last parse, in the order in which they were found. Format them with `format_error`
+        [[nodiscard]] const std::pmr::vector<ParseError> &errors() const {
+            return state->errors;
+        }
+
+        [[nodiscard]] std::string format_error(const ParseError &error) const {
+            return argparse::format_error(*schema, error);
+        }
+
+        void print() const;
+
+        // Identifies the declarations (keys, kinds and types of the entries), such that snapshots are only loaded by the same declarations
+        [[nodiscard]] uint64_t schema_hash() const;
+
+        /* Serialize the state of the last parse into a versioned binary image: the raw values, their source, and the converted data of the
+         * built-in types (numbers, enums, strings, and vectors and optionals of these). Other types are converted again from the raw values when loading.
+         */
+        [[nodiscard]] std::string snapshot() const;
+        bool save_snapshot(const char *path) const;
+
+        /* Restore the state of a parse from an image written by `save_snapshot` (e.g. by a parent process), instead of parsing a commandline.
+         * The file is mapped into memory and string views refer directly into it. Subcommands are not restored.
+         * Throws a std::runtime_error when the image is invalid, or was written by other declarations or another version
+         */
+        void load_snapshot(const char *path);
+
+        /* Answer a completion query of a shell, where `words` are the arguments up to and including the word being completed.
+         * Returns the candidates, one per line: the keys starting with the word (such that an unambiguous abbreviation like `--verb` completes
+         * to `--verbose`), or the allowed values of an enum when the word is the value of a key.
+         * Called by `parse` in the hidden completion mode `program __complete <words...>`, see `completion_script`
+         */
+        std::string complete(const std::string_view *words, size_t n);
+    };
+
+    /* Script that registers the completion of `program` for `shell` ("bash", "zsh" or "fish"), which calls `program __complete <words...>`.
+     * Printed by `program __completion_script <shell>`, e.g. `source <(my_program __completion_script bash)`
+     */
+    std::string completion_script(std::string_view shell, std::string_view program);
+
+#if !defined(ARGPARSE_COMPILED_LIBRARY) || defined(ARGPARSE_INSTANTIATE)
+    using std::cout, std::cerr, std::endl, std::setw;
+
+    ARGPARSE_INLINE MappedFile::MappedFile(const char *path) {
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary);
+        if (file) {
+            buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            data_ = buffer_.data();
+            size_ = buffer_.size();
+            is_open_ = true;
+        }
+#else
+        const int fd = ::open(path, O_RDONLY);
+        struct stat st{};
+        if (fd < 0)
+            return;
+        if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+            size_ = st.st_size;
+            if (size_ == 0) {
+                is_open_ = true;
+            } else {
+                void *data = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED) {
+                    ::madvise(data, size_, MADV_SEQUENTIAL);
+                    data_ = (char *)data;
+                    is_open_ = true;
+                }
+            }
+        }
+        ::close(fd);
+#endif
+    }
+
+    ARGPARSE_INLINE MappedFile::~MappedFile() {
+#ifndef _WIN32
+        if (data_ != nullptr)
+            ::munmap(data_, size_);
+#endif
+    }
+
+    ARGPARSE_INLINE char **environment() {
+#ifdef _WIN32
+        return _environ;
+#else
+        return environ;
+#endif
+    }
+
+    ARGPARSE_INLINE bool path_exists(std::string_view path) {
+        const std::string p(path);
+#ifdef _WIN32
+        return _access(p.c_str(), 0) == 0;
+#else
+        return access(p.c_str(), F_OK) == 0;
+#endif
+    }
+
+    ARGPARSE_INLINE bool path_readable(std::string_view path) {
+        const std::string p(path);
+#ifdef _WIN32
+        return _access(p.c_str(), 4) == 0;
+#else
+        return access(p.c_str(), R_OK) == 0;
+#endif
+    }
+
+    ARGPARSE_INLINE bool is_writable_dir(std::string_view path) {
+        const std::string p(path);
+#ifdef _WIN32
+        struct _stat info;
+        return _stat(p.c_str(), &info) == 0 && (info.st_mode & _S_IFDIR) && _access(p.c_str(), 2) == 0;
+#else
+        struct stat info;
+        return stat(p.c_str(), &info) == 0 && S_ISDIR(info.st_mode) && access(p.c_str(), W_OK | X_OK) == 0;
+#endif
+    }
+
+    ARGPARSE_INLINE long read_descriptor(int fd, char *data, size_t size) {
+        while (true) {
+#ifdef _WIN32
+            return ::_read(fd, data, (unsigned)size);
+#else
+            const long n = ::read(fd, data, size);
+            if (n >= 0 || errno != EINTR)
+                return n;
+#endif
+        }
+    }
+
+    ARGPARSE_INLINE void print_text(std::string_view text) {
+        cout << text << std::flush;
+    }
+
+    ARGPARSE_INLINE void print_warning(std::string_view text) {
+        cerr << text << endl;
+    }
+
+    ARGPARSE_INLINE void report_error(const std::string &error, bool raise_on_error) {
+        if (raise_on_error) {
+            throw std::runtime_error(error);
+        } else {
+            cerr << error << endl;
+            exit(-1);
+        }
+    }
+
+    // Append `str` right-aligned in `width` columns
+    inline std::string &append_padded(std::string &text, std::string_view str, size_t width) {
+        return text.append(width > str.size()? width - str.size() : 0, ' ').append(str);
+    }
+
+    // The help text is rendered into a single buffer, which is written at once
+    ARGPARSE_INLINE void Args::help() {
+        welcome();
+        size_t size = 64 + state->program_name.size();
+        for (uint32_t i = 0; i < schema->info.size(); i++)
+            size += 64 + schema->meta[i].help.size() + schema->meta[i].default_str.value_or("").size();
+        for (const auto &[name, help] : schema->subcommands)
+            size += 24 + name.size() + help.size();
+        std::string text;
+        text.reserve(size);
+
+        text.append("Usage: ").append(state->program_name).append(" ");
+        for (const uint32_t i : schema->arg_entries)
+            text.append(schema->keys[schema->meta[i].first_key]).append(" ");
+        if (!schema->subcommands.empty())
+            text.append("<command> ");
+        text.append(" [options...]\n");
+        for (const uint32_t i : schema->arg_entries) {
+            append_padded(text, schema->keys[schema->meta[i].first_key], 17).append(" : ").append(schema->meta[i].help);
+            _append_info(text, i);
+            text.append("\n");
+        }
+
+        text.append("\nOptions:\n");
+        for (uint32_t i = 0; i < schema->info.size(); i++) {
+            if (schema->info[i].type != Entry::ARG) {
+                append_padded(text, _get_keys(i), 17).append(" : ").append(schema->meta[i].help);
+                _append_info(text, i);
+                text.append("\n");
+            }
+        }
+
+        if (!schema->subcommands.empty()) {
+            text.append("\nCommands:\n");
+            for (const auto &[name, help] : schema->subcommands)
+                append_padded(text, name, 17).append(" : ").append(help).append("\n");
+        }
+        print_text(text);
+    }
+
+    ARGPARSE_INLINE void Args::validate(const bool &raise_on_error) {
+        if (state->errors.empty())
+            return;
+        // report the error of the first declared entry
+        const ParseError &error = *std::min_element(state->errors.begin(), state->errors.end(), [](const auto &a, const auto &b) { return a.entry < b.entry; });
+        report_error(format_error(error), raise_on_error);
+    }
+
+    ARGPARSE_INLINE void Args::_prepare() {
+        compile();
+        const char *stats_variable = std::getenv("ARGPARSE_STATS");
+        state->stats.enabled = state->collect_stats || (stats_variable != nullptr && *stats_variable != '\0');
+        _mark_stats();
+        reset();
+        if (state->converters[schema->help_index] == nullptr)
+            state->converters[schema->help_index] = make_convert<bool>(&state->counter, &state->counter);
+    }
+
+    ARGPARSE_INLINE void Args::parse(int argc, const char* const *argv, const bool &raise_on_error) {
+        _prepare();
+        ParseState &s = *state;
+
+        // hidden completion modes, which exit before the program continues with its own initialization
+        if (argc > 1 && std::string_view(argv[1]) == "__complete") {
+            const std::pmr::vector<std::string_view> words(argv + 2, argv + argc, resource);
+            print_text(complete(words.data(), words.size()));
+            exit(0);
+        } else if (argc > 2 && std::string_view(argv[1]) == "__completion_script") {
+            const std::string_view program = argv[0];
+            const std::string script = completion_script(argv[2], program.substr(program.find_last_of("/\\") + 1));
+            if (script.empty())
+                report_error("unsupported shell for completion: " + std::string(argv[2]), raise_on_error);
+            print_text(script);
+            exit(0);
+        }
+
+        s.program_name = argv[0];
+        s.params.reserve(argc - 1);
+        for (int i = 1; i < argc; i++)
+            add_commandline_token(argv[i], s.params, s.response_files);
+        _parse(raise_on_error);
+    }
+
+    ARGPARSE_INLINE const std::pmr::vector<ParseError> &Args::check(int argc, const char* const *argv) {
+        _prepare();
+        ParseState &s = *state;
+        s.check_only = true;
+        s.program_name = argv[0];
+        s.params.reserve(argc - 1);
+        for (int i = 1; i < argc; i++)
+            add_commandline_token(argv[i], s.params, s.response_files);
+        _parse(false);
+        s.check_only = false;
+        return s.errors;
+    }
+
+    ARGPARSE_INLINE void Args::_parse(const bool &raise_on_error) {
+        const Schema &t = *schema;
+        ParseState &s = *state;
+        const bool &_help = ((ConvertType<bool>*)(s.converters[t.help_index].get()))->data;
+        _end_phase(ParseStats::TOKENIZE);
+
+        // Resolves the keys and positional arguments to the entries of this parser
+        struct Handler {
+            Args &args;
+            const Schema &t;
+            const EntryInfo *find(std::string_view key, uint32_t &index) const {
+                const uint32_t *i = t.kwarg_index.find(key);
+                return i != nullptr? &t.info[index = *i] : nullptr;
+            }
+            void convert(uint32_t i, std::string_view value) { args._convert(i, value); }
+            void convert(uint32_t i, const std::string_view *first, const std::string_view *last) { args._convert(i, first, last); }
+            void missing_value(uint32_t i, std::string_view key) { args._set_error(i, ErrorKind::MISSING_VALUE, key); }
+            void unrecognised(std::string_view key) {
+                if (args.state->check_only)
+                    args._set_error(t.help_index, ErrorKind::UNRECOGNISED_KEY, key);    // reported like an unknown command
+                else
                     cerr << "unrecognised commandline argument: " << key << endl;
+            }
+            bool positional(std::string_view token) {
+                const bool is_first = args.state->arguments_flat.empty();     // only the first positional argument selects a subcommand
+                const uint32_t *subcommand = t.subcommands.empty() || !is_first? nullptr : t.subcommand_index.find(token);
+                if (subcommand != nullptr) {    // the remaining tokens are parsed by the subcommand
+                    args.state->selected_subcommand = *subcommand;
+                    return false;
                 }
-            };
-            auto add_param = [&](size_t &i, const size_t &start) {
-                size_t eq_idx = params[i].find('=');  // check if value was passed using the '=' sign
-                if (eq_idx != std::string::npos) { // key/value from = notation
-                    std::string key = params[i].substr(start, eq_idx - start);
-                    std::string value = params[i].substr(eq_idx + 1);
-                    parse_param(i, key, false, value);
-                } else {
-                    std::string key = std::string(params[i].substr(start));
-                    parse_param(i, key, false);
+                args.state->arguments_flat.emplace_back(token);
+                return true;
+            }
+            [[nodiscard]] bool is_multi_argument(size_t a) const { return t.info[t.arg_entries[a]].is_multi_argument; }
+            void convert_positional(size_t a, std::string_view value) { args._convert(t.arg_entries[a], value); }
+            void convert_positional(size_t a, const std::string_view *first, const std::string_view *last) { args._convert(t.arg_entries[a], first, last); }
+        } handler{*this, t};
+        const size_t n_scanned = scan_commandline(s.params.data(), s.params.size(), handler);
+        assign_positionals(t.arg_entries.size(), s.arguments_flat.data(), s.arguments_flat.size(), handler);
+        if (!t.subcommands.empty() && t.arg_entries.empty() && !s.arguments_flat.empty())
+            _set_error(t.help_index, ErrorKind::UNKNOWN_COMMAND, s.arguments_flat[0]);  // not an error of the help flag, but reported the same way
+        _end_phase(ParseStats::LOOKUP);
+
+        // environment variables of the entries which have not been set on the commandline, in a single pass over the environment
+        if (!t.env_entries.empty()) {
+            for (char **env = environment(); *env != nullptr; ++env) {
+                const std::string_view variable(*env);
+                const size_t eq_idx = variable.find('=');
+                const uint32_t *index = eq_idx != std::string_view::npos? t.env_index.find(variable.substr(0, eq_idx)) : nullptr;
+                if (index != nullptr && !s.state[*index].value.has_value()) {
+                    s.state[*index].source = Source::ENVIRONMENT;
+                    _convert(*index, variable.substr(eq_idx + 1));
                 }
-            };
+            }
+        }
+        _end_phase(ParseStats::ENVIRONMENT);
 
-            std::vector<std::string> arguments_flat;
-            for (size_t i = 0; i < params.size(); i++) {
-                if (!is_value(i)) {
-                    if (params[i].size() > 1 && params[i][1] == '-') {  // long --
-                        add_param(i, 2);
-                    } else { // short -
-                        const size_t j_end = std::min(params[i].size(), params[i].find('=')) - 1;
-                        for (size_t j = 1; j < j_end; j++) { // add possible other flags
-                            const std::string key = std::string(1, params[i][j]);
-                            parse_param(i, key, true);
-                        }
-                        add_param(i, j_end);
-                    }
-                } else {
-                    arguments_flat.emplace_back(params[i]);
+        if (t.config_index.has_value())
+            _read_config_file(*t.config_index);
+        _end_phase(ParseStats::CONFIG_FILE);
+
+        // try to apply default values for arguments which have not been set
+        for (uint32_t i = 0; i < s.state.size(); i++) {
+            if (!s.state[i].value.has_value()) {
+                _apply_default(i);
+            }
+        }
+        _end_phase(ParseStats::DEFAULTS);
+
+        if (_help && !s.check_only) {
+            help();
+            exit(0);
+        }
+
+        _check_values();
+        if (s.check_only)
+            return;
+
+        validate(raise_on_error);
+        _end_phase(ParseStats::VALIDATE);
+        const char *stats_variable = std::getenv("ARGPARSE_STATS");
+        if (stats_variable != nullptr && *stats_variable != '\0')
+            cerr << stats_report();
+
+        if (s.selected_subcommand.has_value()) {
+            Args &command = s.subcommands[*s.selected_subcommand]->create(resource);
+            command._prepare();
+            command.state->program_name.assign(s.program_name).append(" ").append(t.subcommands[*s.selected_subcommand].first);
+            command.state->params.assign(s.params.begin() + n_scanned, s.params.end());  // views into argv or the response files of this parser
+            command._parse(raise_on_error);
+        }
+    }
+
+    ARGPARSE_INLINE void Args::_read_config_file(uint32_t config_entry) {
+        ParseState &s = *state;
+        const EntryState &config = s.state[config_entry];
+        std::pmr::string &path = s.config_path;
+        if (config.value.has_value())
+            path.assign(*config.value);
+        else if (std::string default_path; _append_default(default_path, config_entry))
+            path.assign(default_path);
+        if (path.empty())
+            return;
+        auto file = std::allocate_shared<MappedFile>(std::pmr::polymorphic_allocator<MappedFile>(&state->counter), path.c_str());
+        if (!file->is_open()) {
+            if (config.value.has_value())   // a missing default configuration file is not an error
+                _set_error(config_entry, ErrorKind::UNREADABLE_FILE, *config.value);
+            path.clear();
+            return;
+        }
+
+        std::pmr::string qualified(&state->counter);   // "section.key"
+        parse_config_file(file->data(), file->size(), [&](std::string_view section, std::string_view key, std::string_view value) {
+            const uint32_t *index = nullptr;
+            if (!section.empty())
+                index = schema->kwarg_index.find(qualified.assign(section).append(".").append(key));
+            if (index == nullptr)
+                index = schema->kwarg_index.find(key);
+            if (index == nullptr) {
+                if (s.check_only)
+                    _set_error(schema->help_index, ErrorKind::UNRECOGNISED_KEY, key, path);
+                else
+                    cerr << "unrecognised key in configuration file " << path << ": " << key << endl;
+            } else if (!s.state[*index].value.has_value() || s.state[*index].source == Source::CONFIG_FILE) {    // a repeated key appends, like on the commandline
+                s.state[*index].source = Source::CONFIG_FILE;
+                _convert(*index, value);
+            }
+        });
+        s.response_files.emplace_back(std::move(file));
+    }
+
+    /* Run the checks of all given values on a bounded pool of threads, as each check (e.g. a stat of a path) mostly waits on the filesystem.
+     * The results are recorded afterwards in order, such that the errors do not depend on the scheduling
+     */
+    ARGPARSE_INLINE void Args::_check_values() {
+        const Schema &t = *schema;
+        ParseState &s = *state;
+        if (t.checks.empty())
+            return;
+
+        struct Job {
+            uint32_t first_check, last_check;   // the checks of the entry, in Schema::checks
+            std::string_view value;
+            size_t offset;                      // of the element in a list, or ParseError::no_offset
+            const ValueCheck *failed;
+        };
+        std::pmr::vector<Job> jobs(&s.counter);
+        std::pmr::vector<bool> has_error(t.info.size(), false, &s.counter);
+        for (const ParseError &error : s.errors)
+            has_error[error.entry] = true;      // a value that did not convert is not checked
+        std::pmr::vector<uint32_t> first_check(t.info.size(), ~0u, &s.counter);    // the first check of each entry with checks
+        std::pmr::vector<uint32_t> last_check(t.info.size(), 0, &s.counter);
+        for (uint32_t c = 0; c < t.checks.size(); c++) {
+            const uint32_t i = t.checks[c].entry;
+            first_check[i] = std::min(first_check[i], c);
+            last_check[i] = c + 1;
+        }
+        auto add = [&](uint32_t i, std::string_view value) {
+            if (s.state[i].source == Source::COMMANDLINE && stream_descriptor(value) >= 0) {    // streamed values are not kept
+                return;
+            } else if (s.converters[i]->is_list() && !t.info[i].is_multi_argument) {
+                for_each_split(value, [&](std::string_view element) { jobs.push_back({first_check[i], last_check[i], value, size_t(element.data() - value.data()), nullptr}); });
+            } else if (!value.empty() || s.state[i].source != Source::DEFAULT) {     // an empty default means no value
+                jobs.push_back({first_check[i], last_check[i], value, ParseError::no_offset, nullptr});
+            }
+        };
+        auto is_checked = [&](uint32_t i) { return first_check[i] != ~0u && !has_error[i]; };
+
+        // the multiple values of each checked entry, grouped by entry in a single pass (a counting sort of ParseState::values)
+        std::pmr::vector<uint32_t> values_start(t.info.size() + 1, 0, &s.counter), values_order(&s.counter);
+        for (const auto &value : s.values) {
+            if (is_checked(value.first))
+                values_start[value.first + 1]++;
+        }
+        for (uint32_t i = 0; i < t.info.size(); i++)
+            values_start[i + 1] += values_start[i];
+        values_order.resize(values_start.back());
+        std::pmr::vector<uint32_t> values_end(values_start.begin(), values_start.end() - 1, &s.counter);
+        for (uint32_t k = 0; k < s.values.size(); k++) {
+            if (is_checked(s.values[k].first))
+                values_order[values_end[s.values[k].first]++] = k;
+        }
+
+        // the elements of typed defaults as text, collected before the jobs refer to them
+        std::pmr::vector<std::pmr::string> default_texts(&s.counter);
+        std::pmr::vector<std::pair<uint32_t, uint32_t>> default_range(t.info.size(), {0, 0}, &s.counter);
+        for (uint32_t i = 0; i < t.info.size(); i++) {
+            if (is_checked(i) && !s.state[i].value.has_value() && s.state[i].source == Source::DEFAULT) {
+                default_range[i].first = uint32_t(default_texts.size());
+                if (!s.converters[i]->to_texts(default_texts))     // a default that cannot be formatted is not checked
+                    default_texts.resize(default_range[i].first);
+                default_range[i].second = uint32_t(default_texts.size());
+            }
+        }
+
+        for (uint32_t i = 0; i < t.info.size(); i++) {     // in order of the entries, such that the errors are too
+            const EntryState &entry = s.state[i];
+            if (!is_checked(i)) {
+                continue;
+            } else if (entry.has_values) {
+                for (uint32_t k = values_start[i]; k < values_start[i + 1]; k++)
+                    add(i, s.values[values_order[k]].second);
+            } else if (entry.value.has_value()) {
+                add(i, *entry.value);
+            } else {
+                for (uint32_t k = default_range[i].first; k < default_range[i].second; k++)
+                    jobs.push_back({first_check[i], last_check[i], default_texts[k], ParseError::no_offset, nullptr});
+            }
+        }
+
+        std::atomic<size_t> next{0};
+        auto work = [&]() {
+            for (size_t k; (k = next.fetch_add(1, std::memory_order_relaxed)) < jobs.size();) {
+                Job &job = jobs[k];
+                const std::string_view value = job.offset != ParseError::no_offset? list_element(job.value, job.offset) : job.value;
+                for (uint32_t c = job.first_check; c < job.last_check && job.failed == nullptr; c++) {
+                    bool passed = false;
+                    try {
+                        passed = t.checks[c].predicate(value);
+                    } catch (...) {}    // a check that throws has failed
+                    if (!passed)
+                        job.failed = &t.checks[c];
                 }
             }
+        };
+        const size_t n_threads = std::min(s.check_threads, jobs.size());
+        std::vector<std::thread> threads;
+        for (size_t k = 1; k < n_threads; k++)
+            threads.emplace_back(work);
+        work();
+        for (std::thread &thread : threads)
+            thread.join();
 
-            // Parse all the positional arguments, making sure multi_argument positional arguments are processed last to enable arguments afterwards
-            size_t arg_i = 0;
-            for (; arg_i < arg_entries.size() && !arg_entries[arg_i]->_is_multi_argument; arg_i++) { // iterate over positional arguments until a multi-argument is found
-                if (arg_i < arguments_flat.size())
-                    arg_entries[arg_i]->_convert(arguments_flat[arg_i]);
-            }
-            size_t arg_j = 1;
-            for (size_t j_end = arg_entries.size() - arg_i; arg_j <= j_end; arg_j++) { // iterate from back to front, to ensure non-multi-arguments in the front and back are given preference
-                size_t flat_idx = arguments_flat.size() - arg_j;
-                if (flat_idx < arguments_flat.size() && flat_idx >= arg_i) {
-                    if (arg_entries[arg_entries.size() - arg_j]->_is_multi_argument) {
-                        std::stringstream s;  // Combine multiple arguments into 1 comma-separated string for parsing
-                        copy(&arguments_flat[arg_i],&arguments_flat[flat_idx + 1], std::ostream_iterator<std::string>(s,","));
-                        std::string value = s.str();
-                        value.back() = '\0'; // remove trailing ','
-                        arg_entries[arg_i]->_convert(value);
-                    } else {
-                        arg_entries[arg_entries.size() - arg_j]->_convert(arguments_flat[flat_idx]);
+        for (const Job &job : jobs) {
+            if (job.failed != nullptr)
+                _set_error(job.failed->entry, ErrorKind::FAILED_CHECK, job.value, job.failed->message, job.offset);
+        }
+    }
+
+    ARGPARSE_INLINE void Args::print() const {
+        std::string text, value;
+        text.reserve(64 * schema->info.size());
+        for (uint32_t i = 0; i < schema->info.size(); i++) {
+            const EntryState &entry = state->state[i];
+            const std::string_view help = schema->meta[i].help;
+            std::string keys = _get_keys(i);
+            if (schema->info[i].type == Entry::ARG)
+                keys.append("(").append(help.size() > 10? help.substr(0, 7) : help).append(help.size() > 10? "...)" : ")");
+            value.clear();
+            if (entry.has_values) {
+                bool first = true;
+                for (const auto &[index, v] : state->values) {
+                    if (index == i) {
+                        value.append(first? "" : ",").append(v);
+                        first = false;
                     }
                 }
+            } else if (entry.value.has_value()) {
+                value.append(*entry.value);
+            } else if (entry.source != Source::DEFAULT || !_append_default(value, i)) {
+                value.append("null");
             }
+            append_padded(text, keys, 21).append(" : ").append(entry.source != Source::DEFAULT? bold(value) : value);
+            if (entry.source == Source::ENVIRONMENT)
+                text.append(" (env ").append(schema->meta[i].env_name).append(")");
+            else if (entry.source == Source::CONFIG_FILE)
+                text.append(" (config ").append(state->config_path).append(")");
+            text.append("\n");
+        }
+        print_text(text);
+    }
 
-            // try to apply default values for arguments which have not been set
-            for (const auto &entry : all_entries) {
-                if (!entry->value_.has_value()) {
-                    entry->_apply_default();
-                }
+    inline constexpr std::string_view snapshot_magic = "ARGPARSE";
+    inline constexpr uint32_t snapshot_version = 1;
+
+    ARGPARSE_INLINE uint64_t Args::schema_hash() const {
+        uint64_t hash = 14695981039346656037ull;    // FNV-1a
+        auto mix = [&](std::string_view bytes) {
+            for (const char c : bytes)
+                hash = (hash ^ (unsigned char)c) * 1099511628211ull;
+        };
+        for (uint32_t i = 0; i < schema->info.size(); i++) {
+            const EntryInfo &info = schema->info[i];
+            const size_t type_id = state->converters[i] != nullptr? state->converters[i]->get_type_id() : 0;
+            mix(_get_keys(i));
+            mix(std::string_view(reinterpret_cast<const char*>(&type_id), sizeof(type_id)));
+            mix({info.type == Entry::ARG? "a" : info.type == Entry::KWARG? "k" : "f", 1});
+            mix(info.is_multi_argument? "m" : "s");
+            mix(info.implicit_value.value_or(std::string_view()));
+        }
+        return hash;
+    }
+
+    ARGPARSE_INLINE std::string Args::snapshot() const {
+        const ParseState &s = *state;
+        std::string out(snapshot_magic);
+        write_pod(out, snapshot_version);
+        write_pod(out, uint32_t(s.state.size()));
+        write_pod(out, schema_hash());
+        std::string data;
+        for (uint32_t i = 0; i < s.state.size(); i++) {
+            const EntryState &entry = s.state[i];
+            data.clear();
+            const bool has_data = s.converters[i] != nullptr && s.converters[i]->save(data);
+            write_pod(out, uint8_t(entry.value.has_value() | entry.has_values << 1 | has_data << 2));
+            write_pod(out, uint8_t(entry.source));
+            if (entry.value.has_value())
+                write_bytes(out, *entry.value);
+            if (has_data)
+                write_bytes(out, data);
+        }
+        write_pod(out, uint64_t(s.values.size()));
+        for (const auto &[index, value] : s.values) {
+            write_pod(out, index);
+            write_bytes(out, value);
+        }
+        return out;
+    }
+
+    ARGPARSE_INLINE bool Args::save_snapshot(const char *path) const {
+        const std::string image = snapshot();
+        FILE *file = std::fopen(path, "wb");
+        if (file == nullptr)
+            return false;
+        const bool is_written = std::fwrite(image.data(), 1, image.size(), file) == image.size();
+        return std::fclose(file) == 0 && is_written;
+    }
+
+    ARGPARSE_INLINE void Args::load_snapshot(const char *path) {
+        _prepare();
+        ParseState &s = *state;
+        auto file = std::allocate_shared<MappedFile>(std::pmr::polymorphic_allocator<MappedFile>(&s.counter), path);
+        if (!file->is_open())
+            throw std::runtime_error("Could not read snapshot \"" + std::string(path) + "\"");
+        std::string_view in(file->data(), file->size());
+        s.response_files.emplace_back(std::move(file));     // the values are views into the image
+        auto invalid = [&](const std::string &reason) {
+            return std::runtime_error("Invalid snapshot \"" + std::string(path) + "\": " + reason);
+        };
+
+        uint32_t version = 0, n_entries = 0;
+        uint64_t hash = 0;
+        if (in.substr(0, snapshot_magic.size()) != snapshot_magic)
+            throw invalid("not a snapshot");
+        in.remove_prefix(snapshot_magic.size());
+        if (!read_pod(in, version) || version != snapshot_version)
+            throw invalid("unsupported version " + std::to_string(version));
+        if (!read_pod(in, n_entries) || !read_pod(in, hash) || n_entries != s.state.size() || hash != schema_hash())
+            throw invalid("written by other declarations");
+
+        std::pmr::vector<uint32_t> replay(&s.counter);  // entries of which the data is converted again from the raw values
+        for (uint32_t i = 0; i < n_entries; i++) {
+            EntryState &entry = s.state[i];
+            uint8_t flags = 0, source = 0;
+            std::string_view value, data;
+            if (!read_pod(in, flags) || !read_pod(in, source) || ((flags & 1) && !read_bytes(in, value)) || ((flags & 4) && !read_bytes(in, data)))
+                throw invalid("truncated");
+            if (flags & 1)
+                entry.value = value;
+            entry.has_values = flags & 2;
+            entry.source = Source(source);
+            if (flags & 4) {
+                if (!s.converters[i]->load(data) || !data.empty())
+                    throw invalid("corrupt data for " + _describe(i));
+            } else if (entry.source == Source::DEFAULT) {
+                _apply_default(i);
+            } else if (entry.value.has_value()) {
+                replay.emplace_back(i);
             }
+        }
+        uint64_t n_values = 0;
+        if (!read_pod(in, n_values))
+            throw invalid("truncated");
+        s.values.reserve(n_values);
+        for (uint64_t k = 0; k < n_values; k++) {
+            uint32_t index = 0;
+            std::string_view value;
+            if (!read_pod(in, index) || !read_bytes(in, value) || index >= n_entries)
+                throw invalid("truncated");
+            s.values.emplace_back(index, value);
+        }
 
-            if (_help) {
-                help();
-                exit(0);
+        for (const uint32_t i : replay) {   // the same conversions as the original parse
+            ConvertBase &data = *s.converters[i];
+            std::errc ec = std::errc();
+            if (!s.state[i].has_values) {
+                ec = data.convert(*s.state[i].value);
+            } else {
+                bool first = true;
+                data.clear();
+                for (const auto &[index, value] : s.values) {
+                    if (index == i && ec == std::errc()) {
+                        ec = schema->info[i].is_multi_argument? data.append(value) : first? data.convert(value) : data.append_list(value);
+                        first = false;
+                    }
+                }
             }
+            if (ec != std::errc())
+                throw invalid("could not convert the value of " + _describe(i));
+        }
+    }
+
+    ARGPARSE_INLINE std::string Args::stats_report(size_t n_slowest) const {
+        const ParseStats &stats = state->stats;
+        auto line = [](std::ostream &out, std::string_view name, const ParseStats::Counters &c) {
+            out << setw(17) << name << " : " << setw(10) << double(c.ns) / 1e3 << " us, " << setw(6) << c.allocations << " allocations, " << setw(8) << c.bytes << " bytes\n";
+        };
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1) << "Parse statistics of " << state->program_name << ":\n";
+        ParseStats::Counters total;
+        for (size_t p = 0; p < ParseStats::N_PHASES; p++) {
+            line(out, ParseStats::phase_names[p], stats.phases[p]);
+            total += stats.phases[p];
+        }
+        line(out, "total", total);
 
-            validate(raise_on_error);
+        std::vector<uint32_t> slowest;
+        for (uint32_t i = 0; i < stats.entries.size(); i++) {
+            if (stats.entries[i].ns > 0)
+                slowest.emplace_back(i);
         }
+        std::sort(slowest.begin(), slowest.end(), [&](uint32_t a, uint32_t b) { return stats.entries[a].ns > stats.entries[b].ns; });
+        if (!slowest.empty())
+            out << "Slowest conversions:\n";
+        for (size_t k = 0; k < std::min(n_slowest, slowest.size()); k++)
+            line(out, _get_keys(slowest[k]), stats.entries[slowest[k]]);
+        return out.str();
+    }
+
+    ARGPARSE_INLINE std::string Args::complete(const std::string_view *words, size_t n) {
+        compile();
+        const Schema &t = *schema;
+        std::string candidates;
+        auto complete_values = [&](std::string_view key, std::string_view prefix, std::string_view value) {
+            const uint32_t *index = t.kwarg_index.find(key);
+            if (index == nullptr || state->converters.size() <= *index || state->converters[*index] == nullptr)
+                return;
+            const std::string_view allowed = state->converters[*index]->get_allowed_entries();    // "a, b, c, "
+            for (size_t start = 0, end; (end = allowed.find(", ", start)) != std::string_view::npos; start = end + 2) {
+                const std::string_view candidate = allowed.substr(start, end - start);
+                if (iequals(candidate.substr(0, value.size()), value))
+                    candidates.append(prefix).append(candidate).append("\n");
+            }
+        };
 
-        void print() const {
-            for (const auto &entry : all_entries) {
-                std::string snip = entry->type == Entry::ARG ? "(" + (entry->help.size() > 10 ? entry->help.substr(0, 7) + "..." : entry->help) + ")" : "";
-                cout << setw(21) << entry->_get_keys() + snip << " : " << (entry->is_set_by_user? bold(entry->value_.value_or("null")) : entry->value_.value_or("null")) << endl;
+        const std::string_view word = n > 0? words[n - 1] : std::string_view();
+        const std::string_view previous = n > 1? words[n - 2] : std::string_view();
+        const size_t eq_idx = word.find('=');
+        if (previous.size() > 1 && previous[0] == '-' && !std::isdigit((unsigned char)previous[1]) && previous.find('=') == std::string_view::npos) {
+            const std::string_view key = previous.substr(previous[1] == '-'? 2 : 1);
+            const uint32_t *index = t.kwarg_index.find(key);
+            if (index != nullptr && !t.info[*index].implicit_value.has_value()) {   // the word is the value of the previous key, e.g. `--color bl`
+                complete_values(key, "", word);
+                return candidates;
+            }
+        }
+        if (word.substr(0, 2) == "--" && eq_idx != std::string_view::npos) {
+            complete_values(word.substr(2, eq_idx - 2), word.substr(0, eq_idx + 1), word.substr(eq_idx + 1));
+        } else if (word == "-" || word.substr(0, 2) == "--") {
+            PrefixTrie trie(resource);
+            for (const auto &[key, index] : t.kwarg_entries) {
+                if (key.size() > 1)
+                    trie.insert(key);
+                else if (word == "-")
+                    candidates.append("-").append(key).append("\n");
             }
+            trie.complete(word.substr(std::min<size_t>(2, word.size())), [&](std::string_view key) { candidates.append("--").append(key).append("\n"); });
+        } else if (word.size() == 2 && word[0] == '-' && t.kwarg_entries.count(word.substr(1))) {
+            candidates.append(word).append("\n");
+        } else if (word.empty() || word[0] != '-') {
+            for (const auto &[name, index] : t.subcommand_entries) {
+                if (name.substr(0, word.size()) == word)
+                    candidates.append(name).append("\n");
+            }
+        }
+        return candidates;
+    }
+
+    ARGPARSE_INLINE std::string completion_script(std::string_view shell, std::string_view program) {
+        std::string name(program);      // used in the name of the shell function
+        std::replace_if(name.begin(), name.end(), [](char c) { return !std::isalnum((unsigned char)c); }, '_');
+        std::string script;
+        if (shell == "bash") {
+            script = "_argparse_complete_NAME() {\n"
+                     "    local line=\"${COMP_LINE:0:COMP_POINT}\" words\n"
+                     "    read -r -a words <<< \"$line\"\n"
+                     "    [[ \"$line\" == *\" \" ]] && words+=(\"\")\n"
+                     "    local IFS=$'\\n'\n"
+                     "    COMPREPLY=($(\"${words[0]}\" __complete \"${words[@]:1}\" 2>/dev/null))\n"
+                     "    if [[ \"${words[${#words[@]}-1]}\" == *=* && \"$COMP_WORDBREAKS\" == *=* ]]; then\n"
+                     "        COMPREPLY=(\"${COMPREPLY[@]#*=}\")\n"
+                     "    fi\n"
+                     "}\n"
+                     "complete -o default -F _argparse_complete_NAME PROGRAM\n";
+        } else if (shell == "zsh") {
+            script = "#compdef PROGRAM\n"
+                     "_argparse_complete_NAME() {\n"
+                     "    local -a candidates\n"
+                     "    candidates=(\"${(@f)$(\"${words[1]}\" __complete \"${(@)words[2,CURRENT]}\" 2>/dev/null)}\")\n"
+                     "    if [[ -n \"${candidates[1]}\" ]]; then\n"
+                     "        compadd -Q -- \"${candidates[@]}\"\n"
+                     "    else\n"
+                     "        _files\n"
+                     "    fi\n"
+                     "}\n"
+                     "compdef _argparse_complete_NAME PROGRAM\n";
+        } else if (shell == "fish") {
+            script = "function __argparse_complete_NAME\n"
+                     "    set -l tokens (commandline -opc) (commandline -ct)\n"
+                     "    $tokens[1] __complete $tokens[2..-1] 2>/dev/null\n"
+                     "end\n"
+                     "complete -c PROGRAM -a '(__argparse_complete_NAME)'\n";
+        }
+        for (const auto &[placeholder, value] : {std::pair<std::string_view, std::string_view>{"NAME", name}, {"PROGRAM", program}}) {
+            for (size_t i = script.find(placeholder); i != std::string::npos; i = script.find(placeholder, i + value.size()))
+                script.replace(i, placeholder.size(), value);
+        }
+        return script;
+    }
+#endif
+
+    // Declarations are only recorded while the schema is being built, a shared schema already contains them
+    template <typename T> Entry &Entry::set_default(const T &default_value) {
+        Schema *s = args.declaring;
+        if (s == nullptr)
+            return *this;
+        if constexpr (std::is_convertible<const T&, std::string_view>::value)
+            s->meta[index].default_str = s->strings.intern(std::string_view(default_value));
+        else
+            s->meta[index].default_str.reset();     // formatted only when it is shown, see Args::_append_default
+        if constexpr (!(std::is_array<T>::value || std::is_same<typename std::remove_all_extents<T>::type, char>::value)) {
+            s->data_defaults[index] = make_convert<T>(args.resource, default_value);
+        } else {
+            s->data_defaults[index].reset();
+        }
+        return *this;
+    }
+
+    inline Entry &Entry::multi_argument() {
+        if (args.declaring != nullptr)
+            args.declaring->info[index].is_multi_argument = true;
+        return *this;
+    }
+
+    inline Entry &Entry::config_file() {
+        if (args.declaring != nullptr)
+            args.declaring->config_index = index;
+        return *this;
+    }
+
+    inline Entry &Entry::reloadable() {
+        if (args.declaring != nullptr)
+            args.declaring->info[index].is_reloadable = true;
+        return *this;
+    }
+
+    inline Entry &Entry::must_exist() {
+        return satisfies(path_exists, "does not exist");
+    }
+
+    inline Entry &Entry::readable() {
+        return satisfies(path_readable, "is not readable");
+    }
+
+    inline Entry &Entry::writable_dir() {
+        return satisfies(is_writable_dir, "is not a writable directory");
+    }
+
+    inline Entry &Entry::satisfies(std::function<bool(std::string_view value)> predicate, std::string_view message) {
+        Schema *s = args.declaring;
+        if (s != nullptr) {
+            const auto after = std::upper_bound(s->checks.begin(), s->checks.end(), index, [](uint32_t i, const ValueCheck &check) { return i < check.entry; });
+            s->checks.insert(after, {index, std::move(predicate), s->strings.intern(message)});
+        }
+        return *this;
+    }
+
+    inline Entry &Entry::env(std::string_view name) {
+        Schema *s = args.declaring;
+        if (s != nullptr) {
+            s->meta[index].env_name = s->strings.intern(name);
+            s->env_entries[s->meta[index].env_name] = index;
+        }
+        return *this;
+    }
+
+    template <typename T> struct Subcommand : public SubcommandBase {
+        std::shared_ptr<T> instance;
+
+        Args &create(std::pmr::memory_resource *resource) override {
+            if constexpr (std::is_constructible<T, std::pmr::memory_resource*>::value)
+                instance = std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource), resource);
+            else
+                instance = std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource));
+            return *instance;
+        }
+
+        void reset() override {
+            instance.reset();
         }
     };
 
+    template <typename T> std::shared_ptr<T> &Args::subcommand(std::string_view name, std::string_view help) {
+        static_assert(std::is_base_of<Args, T>::value, "a subcommand needs to be derived from argparse::Args");
+        if (declaring != nullptr) {
+            const auto index = (uint32_t)declaring->subcommands.size();
+            declaring->subcommands.emplace_back(declaring->strings.intern(name), declaring->strings.intern(help));
+            declaring->subcommand_entries[declaring->subcommands.back().first] = index;
+        } else if (n_subcommands >= schema->subcommands.size() || schema->subcommands[n_subcommands].first != name) {
+            throw std::logic_error("argparse: the declared subcommands do not match the schema");
+        }
+        n_subcommands++;
+        auto &subcommands = state->subcommands;
+        subcommands.emplace_back(make_unique_in<SubcommandBase, Subcommand<T>>(resource));
+        return ((Subcommand<T>*)subcommands.back().get())->instance;
+    }
+
+    template <typename T> Entry::operator T&() {
+        Schema *s = args.declaring;
+        // A default of another type (e.g. a double for a float) is converted from its text, like a default given as a string
+        if (s != nullptr && s->data_defaults[index] != nullptr && s->data_defaults[index]->get_type_id() != typeid(T).hash_code()) {
+            if (!s->meta[index].default_str.has_value())
+                s->meta[index].default_str = s->strings.intern(s->data_defaults[index]->to_string());
+            s->data_defaults[index].reset();
+        }
+        // Automatically set the default to nullptr for pointer types and empty for optional types
+        if constexpr (is_optional<T>::value || std::is_pointer<T>::value || is_shared_ptr<T>::value) {
+            if (s != nullptr && !s->meta[index].default_str.has_value() && s->data_defaults[index] == nullptr) {
+                s->meta[index].default_str = "none";
+                if constexpr(is_optional<T>::value) {
+                    s->data_defaults[index] = make_convert<T>(args.resource, T{std::nullopt});
+                } else {
+                    s->data_defaults[index] = make_convert<T>(args.resource, (T) nullptr);
+                }
+            }
+        }
+
+        auto &converters = args.state->converters;
+        if (converters.size() <= index)
+            converters.resize(index + 1);
+        converters[index] = make_convert<T>(&args.state->counter, &args.state->counter);
+        return ((ConvertType<T>*)(converters[index].get()))->data;
+    }
+
     template <typename T> T parse(int argc, const char* const *argv, const bool &raise_on_error=false) {
         T args = T();
         args.parse(argc, argv, raise_on_error);
         return args;
     }
+
+    // Parse using a memory resource for all allocations, which requires T to forward the constructor (`using argparse::Args::Args;`)
+    template <typename T> T parse(int argc, const char* const *argv, std::pmr::memory_resource *resource, const bool &raise_on_error=false) {
+        T args(resource);
+        args.parse(argc, argv, raise_on_error);
+        return args;
+    }
+
+    /* Build the schema of T once, such that it can be shared by many Args objects (e.g. one per thread) that parse repeatedly:
+     *     static const auto schema = argparse::compile<MyArgs>();
+     *     MyArgs args(schema);    // requires `using argparse::Args::Args;` in MyArgs
+     *     args.parse(argc, argv, true);
+     */
+    template <typename T> std::shared_ptr<const Schema> compile(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) {
+        T args(resource);
+        return args.compile();
+    }
+
+    /* A field of a plain struct T, parsed by a StaticSchema. Created by `argparse::arg`, `argparse::kwarg` and `argparse::flag`.
+     * Like in Args, a field without default value is required, unless it is an optional or a pointer.
+     */
+    template <typename T, typename M> struct Field {
+        using type = M;
+        M T::*member;
+        std::string_view keys;          // comma-separated, empty for positional arguments
+        std::string_view help;
+        EntryInfo info;
+        std::optional<std::string_view> default_str = std::nullopt;
+
+        // The default is given as string, as it is stored in the (constexpr) schema, and converted like a commandline value
+        [[nodiscard]] constexpr Field set_default(std::string_view value) const {
+            return {member, keys, help, info, value};
+        }
+
+        [[nodiscard]] constexpr Field multi_argument() const {
+            return {member, keys, help, {info.implicit_value, info.type, true}, default_str};
+        }
+    };
+
+    template <typename T, typename M> constexpr Field<T, M> arg(M T::*member, std::string_view help) {
+        return {member, {}, help, {std::nullopt, Entry::ARG}};
+    }
+
+    template <typename T, typename M> constexpr Field<T, M> kwarg(M T::*member, std::string_view key, std::string_view help, std::optional<std::string_view> implicit_value=std::nullopt) {
+        return {member, key, help, {implicit_value, Entry::KWARG}};
+    }
+
+    template <typename T> constexpr Field<T, bool> flag(bool T::*member, std::string_view key, std::string_view help) {
+        return kwarg(member, key, help, "true").set_default("false");
+    }
+
+    /* Parser of which the options and their types are known at compile time, which parses directly into the members of a plain struct T:
+     *     struct Options { std::string src; int k; bool verbose; };
+     *     constexpr auto schema = argparse::make_schema(argparse::arg(&Options::src, "Source path"),
+     *                                                   argparse::kwarg(&Options::k, "k,key", "An integer").set_default("3"),
+     *                                                   argparse::flag(&Options::verbose, "v,verbose", "Verbose output"));
+     *     Options options = schema.parse(argc, argv);
+     * The keys are sorted at compile time and each value is converted by a direct call, without converter objects, virtual functions or RTTI.
+     */
+    template <typename T, typename... Fields> class StaticSchema {
+        static constexpr size_t n_fields = sizeof...(Fields);
+        static constexpr size_t max_keys_per_field = 4;
+        static constexpr uint32_t help_field = n_fields;    // `--help` is handled as an extra field
+        static constexpr EntryInfo help_info = {"true", Entry::KWARG};
+
+        struct Key {
+            std::string_view key;
+            uint32_t field = 0;
+        };
+
+        std::tuple<Fields...> fields;
+        std::array<Key, n_fields * max_keys_per_field + 1> keys{};     // sorted, for a binary search
+        size_t n_keys = 0;
+        std::array<uint32_t, n_fields + 1> positionals{};              // field index of each positional argument
+        size_t n_positionals = 0;
+
+        constexpr void add_key(std::string_view key, uint32_t field) {
+            size_t i = n_keys++;
+            for (; i > 0 && key < keys[i - 1].key; i--)         // insertion sort
+                keys[i] = keys[i - 1];
+            keys[i] = Key{key, field};
+        }
+
+        template <size_t I> constexpr void add_field() {
+            const auto &field = std::get<I>(fields);
+            if (field.info.type == Entry::ARG) {
+                positionals[n_positionals++] = I;
+                return;
+            }
+            size_t n = 0;
+            for (size_t start = 0; start < field.keys.size(); start = field.keys.find(',', start) + 1) {
+                if (++n > max_keys_per_field)
+                    throw std::logic_error("argparse: too many keys for one field");
+                add_key(field.keys.substr(start, std::min(field.keys.find(',', start), field.keys.size()) - start), I);
+                if (field.keys.find(',', start) == std::string_view::npos)
+                    break;
+            }
+        }
+
+        template <size_t... Is> constexpr void add_fields(std::index_sequence<Is...>) {
+            (add_field<Is>(), ...);
+        }
+
+        // Call f with the field at runtime index i, through a chain of comparisons that compilers turn into a jump table
+        template <typename F, size_t... Is> static void visit(const std::tuple<Fields...> &fields, uint32_t i, F &&f, std::index_sequence<Is...>) {
+            (void)((i == Is? (f(std::get<Is>(fields)), true) : false) || ...);
+        }
+        template <typename F> void visit(uint32_t i, F &&f) const {
+            visit(fields, i, f, std::index_sequence_for<Fields...>());
+        }
+
+        const EntryInfo *find(std::string_view key, uint32_t &field) const {
+            const Key *first = keys.data(), *last = keys.data() + n_keys;
+            const Key *it = std::lower_bound(first, last, key, [](const Key &k, std::string_view v) { return k.key < v; });
+            if (it == last || it->key != key)
+                return nullptr;
+            field = it->field;
+            const EntryInfo *info = &help_info;
+            if (field != help_field)
+                visit(field, [&](const auto &f) { info = &f.info; });
+            return info;
+        }
+
+        template <typename F> [[nodiscard]] std::string get_keys(const F &field, uint32_t i) const {
+            std::string keys;
+            if (field.info.type == Entry::ARG)
+                keys.append("arg_").append(std::to_string(std::find(positionals.begin(), positionals.begin() + n_positionals, i) - positionals.begin()));
+            for_each_split(field.keys, [&](std::string_view key) {
+                keys.append(keys.empty()? "" : ",").append(key.size() > 1 ? "--" : "-").append(key);
+            });
+            return keys;
+        }
+
+        template <typename F> [[nodiscard]] std::string describe(const F &field, uint32_t i) const {
+            return get_keys(field, i) + " (" + std::string(field.help) + ")";
+        }
+
+    public:
+        constexpr explicit StaticSchema(Fields... f) : fields(f...) {
+            add_fields(std::index_sequence_for<Fields...>());
+            add_key("help", help_field);
+        }
+
+        [[nodiscard]] std::string help(std::string_view program_name) const {
+            auto pad = [](std::string s) { return s.size() < 17? std::string(17 - s.size(), ' ') + s : s; };
+            auto info = [](const auto &field) {
+                using M = typename std::decay_t<decltype(field)>::type;
+                const std::string_view allowed = allowed_entries<M>();
+                std::string text = " [";
+                if (!allowed.empty())
+                    text.append("allowed: <").append(allowed.substr(0, allowed.size() - 2)).append(">, ");
+                if (field.info.implicit_value.has_value())
+                    text.append("implicit: \"").append(*field.info.implicit_value).append("\", ");
+                if (field.default_str.has_value())
+                    text.append("default: ").append(*field.default_str);
+                else
+                    text.append(is_optional<M>::value || std::is_pointer<M>::value || is_shared_ptr<M>::value? "default: none" : "required");
+                return text + "]";
+            };
+
+            std::string text = "Usage: " + std::string(program_name) + " ";
+            for (size_t a = 0; a < n_positionals; a++)
+                text.append("arg_").append(std::to_string(a)).append(" ");
+            text.append(" [options...]\n");
+            for (size_t a = 0; a < n_positionals; a++) {
+                visit(positionals[a], [&](const auto &field) {
+                    text.append(pad("arg_" + std::to_string(a))).append(" : ").append(field.help).append(info(field)).append("\n");
+                });
+            }
+            text.append("\nOptions:\n");
+            for (uint32_t i = 0; i < n_fields; i++) {
+                visit(i, [&](const auto &field) {
+                    if (field.info.type != Entry::ARG)
+                        text.append(pad(get_keys(field, i))).append(" : ").append(field.help).append(info(field)).append("\n");
+                });
+            }
+            return text.append(pad("--help")).append(" : print help [implicit: \"true\", default: false]\n");
+        }
+
+        /* Parse the commandline into a new T, where fields that are not given keep the value of their default (or of the default member initializer of T).
+         * Upon error, it will print the error and exit, or throw a std::runtime_error when raise_on_error is set
+         */
+        T parse(int argc, const char* const *argv, const bool &raise_on_error=false) const {
+            T out{};
+            std::array<bool, n_fields + 1> is_set{};
+            bool print_help = false;
+            std::string error;
+            uint32_t error_field = help_field;      // report the error of the first declared field
+
+            std::pmr::vector<std::string_view> params;
+            std::pmr::vector<std::shared_ptr<MappedFile>> response_files;
+            params.reserve(argc - 1);
+            for (int i = 1; i < argc; i++)
+                add_commandline_token(argv[i], params, response_files);
+
+            auto set_error = [&](uint32_t field, std::string message) {
+                if (error.empty() || field < error_field) {
+                    error = std::move(message);
+                    error_field = field;
+                }
+            };
+            auto convert_value = [&](uint32_t i, std::string_view value) {
+                if (i == help_field) {
+                    print_help = true;
+                    return;
+                }
+                const bool repeated = is_set[i];    // a repeated key (e.g. `-I a -I b`) appends to vectors instead of replacing them
+                is_set[i] = true;
+                visit(i, [&](const auto &field) {
+                    auto &data = out.*field.member;
+                    size_t offset = ParseError::no_offset;
+                    std::string e = conversion_error(value, [&]() { return describe(field, i); },
+                                                     [&]() { return repeated? append_list_to(value, data, &offset) : assign_to(value, data, &offset); }, offset);
+                    if (!e.empty())
+                        set_error(i, std::move(e));
+                });
+            };
+            auto convert_values = [&](uint32_t i, const std::string_view *first, const std::string_view *last) {
+                visit(i, [&](const auto &field) {
+                    auto &data = out.*field.member;
+                    using M = typename std::decay_t<decltype(field)>::type;
+                    if constexpr (is_vector<M>::value || is_range_list<M>::value) {
+                        if (!is_set[i])
+                            data.clear();
+                    }
+                    if constexpr (is_vector<M>::value)
+                        reserve_more(data, last - first);
+                    is_set[i] = true;
+                    for (; first != last; ++first) {
+                        std::string e = conversion_error(*first, [&]() { return describe(field, i); },
+                                                         [&]() { return append_to(*first, data); });
+                        if (!e.empty())
+                            return set_error(i, std::move(e));
+                    }
+                });
+            };
+
+            std::pmr::vector<std::string_view> arguments_flat;
+            struct Handler {
+                const StaticSchema &schema;
+                decltype(convert_value) &single;
+                decltype(convert_values) &multi;
+                decltype(set_error) &error;
+                std::pmr::vector<std::string_view> &arguments_flat;
+
+                const EntryInfo *find(std::string_view key, uint32_t &index) const { return schema.find(key, index); }
+                void convert(uint32_t i, std::string_view value) { single(i, value); }
+                void convert(uint32_t i, const std::string_view *first, const std::string_view *last) { multi(i, first, last); }
+                void missing_value(uint32_t i, std::string_view key) { error(i, "No value provided for: " + std::string(key)); }
+                void unrecognised(std::string_view key) { print_warning("unrecognised commandline argument: " + std::string(key)); }
+                bool positional(std::string_view token) { arguments_flat.emplace_back(token); return true; }
+                [[nodiscard]] bool is_multi_argument(size_t a) const {
+                    bool multi_argument = false;
+                    schema.visit(schema.positionals[a], [&](const auto &field) { multi_argument = field.info.is_multi_argument; });
+                    return multi_argument;
+                }
+                void convert_positional(size_t a, std::string_view value) { single(schema.positionals[a], value); }
+                void convert_positional(size_t a, const std::string_view *first, const std::string_view *last) { multi(schema.positionals[a], first, last); }
+            } handler{*this, convert_value, convert_values, set_error, arguments_flat};
+            scan_commandline(params.data(), params.size(), handler);
+            assign_positionals(n_positionals, arguments_flat.data(), arguments_flat.size(), handler);
+
+            // apply the defaults of the fields which have not been set
+            for (uint32_t i = 0; i < n_fields; i++) {
+                if (is_set[i])
+                    continue;
+                visit(i, [&](const auto &field) {
+                    using M = typename std::decay_t<decltype(field)>::type;
+                    if (field.default_str.has_value())
+                        convert_value(i, *field.default_str);
+                    else if (!(is_optional<M>::value || std::is_pointer<M>::value || is_shared_ptr<M>::value))
+                        set_error(i, "Argument missing: " + describe(field, i));
+                });
+            }
+
+            if (print_help) {
+                print_text(help(argv[0]));
+                exit(0);
+            }
+            if (!error.empty())
+                report_error(error, raise_on_error);
+            return out;
+        }
+    };
+
+    template <typename T, typename... Ms> constexpr StaticSchema<T, Field<T, Ms>...> make_schema(Field<T, Ms>... fields) {
+        return StaticSchema<T, Field<T, Ms>...>(fields...);
+    }
+
+#ifdef ARGPARSE_COMPILED_LIBRARY
+#define ARGPARSE_COMMON_TYPES(X) X(bool) X(char) X(int) X(unsigned int) X(long) X(unsigned long) X(long long) X(unsigned long long) X(float) X(double) \
+        X(std::string) X(std::string_view) X(std::vector<int>) X(std::vector<float>) X(std::vector<double>) X(std::vector<std::string>) X(std::vector<std::string_view>) \
+        X(std::optional<int>) X(std::optional<double>) X(std::optional<std::string>)
+#define ARGPARSE_INSTANTIATE_TYPE(T) \
+        ARGPARSE_EXTERN template struct ConvertType<T>; \
+        ARGPARSE_EXTERN template Entry::operator T&(); \
+        ARGPARSE_EXTERN template Entry &Entry::set_default(const T &);
+    ARGPARSE_COMMON_TYPES(ARGPARSE_INSTANTIATE_TYPE)
+#undef ARGPARSE_INSTANTIATE_TYPE
+#endif
 }
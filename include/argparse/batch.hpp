@@ -0,0 +1,63 @@
+#pragma once
+/* @author: Morris Franken
+ * Checking many commandlines concurrently with `argparse::validate_batch`, kept out of argparse.hpp such that only the translation units
+ * that use it include <thread>
+ */
+#include "argparse.hpp"
+
+#include <atomic>              // for atomic
+#include <exception>           // for exception_ptr, rethrow_exception
+#include <thread>              // for thread, hardware_concurrency
+
+namespace argparse {
+    // The errors of each commandline of a batch, see `validate_batch`
+    struct BatchResult {
+        std::shared_ptr<const Schema> schema;
+        std::vector<std::vector<ParseError>> errors;    // empty for a valid commandline
+
+        [[nodiscard]] std::string format_error(const ParseError &error) const {
+            return argparse::format_error(*schema, error);
+        }
+    };
+
+    /* Check many commandlines (each including the program name, like argv) against the schema of T, concurrently on `n_threads` threads
+     * (0 for one per core). Each thread reuses a single T for its share of the commandlines, and all of them share the compiled schema.
+     * All errors of each commandline are collected with `Args::check`, such that nothing is printed and the messages are only formatted on request.
+     * T needs to forward the constructors of argparse::Args (`using argparse::Args::Args;`)
+     */
+    template <typename T> BatchResult validate_batch(const std::vector<std::vector<std::string>> &commandlines, size_t n_threads = 0) {
+        BatchResult result{compile<T>(), std::vector<std::vector<ParseError>>(commandlines.size())};
+        n_threads = std::min<size_t>(n_threads > 0? n_threads : std::max(1u, std::thread::hardware_concurrency()), commandlines.size());
+        std::atomic<size_t> next{0};
+        std::vector<std::exception_ptr> exceptions(n_threads);
+        auto work = [&](size_t thread) {
+            try {
+                T args(result.schema);
+                std::vector<const char*> argv;
+                for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < commandlines.size();) {
+                    argv.clear();
+                    for (const std::string &token : commandlines[i])
+                        argv.emplace_back(token.c_str());
+                    if (argv.empty())
+                        argv.emplace_back("");  // the program name
+                    const auto &errors = args.check(int(argv.size()), argv.data());
+                    result.errors[i].assign(errors.begin(), errors.end());
+                }
+            } catch (...) {
+                exceptions[thread] = std::current_exception();
+            }
+        };
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < n_threads; t++)
+            threads.emplace_back(work, t);
+        if (n_threads > 0)
+            work(0);
+        for (std::thread &thread : threads)
+            thread.join();
+        for (const std::exception_ptr &e : exceptions) {
+            if (e)
+                std::rethrow_exception(e);
+        }
+        return result;
+    }
+}
@@ -0,0 +1,220 @@
+#pragma once
+/* @author: Morris Franken
+ * Options that are reloaded while other threads read them, see `argparse::Reloadable`. Kept out of argparse.hpp such that only the
+ * translation units that use it include the thread and signal headers
+ */
+#include "argparse.hpp"
+
+#include <atomic>              // for atomic
+#include <mutex>               // for mutex, lock_guard
+#include <thread>              // for thread, this_thread::yield
+
+#ifndef _WIN32
+#include <signal.h>            // for sigaction, SIGHUP
+#include <unistd.h>            // for pipe, read, write, close
+#endif
+
+namespace argparse {
+#ifndef _WIN32
+    inline std::atomic<int> reload_signal_fd{-1};      // write end of the pipe of the Reloadable that reloads on a signal
+
+    inline void on_reload_signal(int) {
+        const int fd = reload_signal_fd.load();
+        const char reload = 1;
+        if (fd >= 0)
+            (void)!::write(fd, &reload, 1);     // async-signal-safe, the reload itself is done by the thread reading the pipe
+    }
+#endif
+
+    /* Options of a long-running program that are reloaded while other threads read them. On a reload, the entries marked `reloadable()` take
+     * the values of the (new) commandline, the environment and the configuration file, and the others keep the values of the first parse.
+     * Each reload parses a new T off the hot path and publishes it with an atomic pointer swap (RCU-style): readers never lock, and always see
+     * a complete version. The previous version is destroyed once its last reader is done, so a `Reader` should be short-lived (and a thread
+     * must not reload while holding one). The first version is kept, as the values that are not reloaded are views into its commandline and files. T needs to forward the constructors of argparse::Args (`using argparse::Args::Args;`) to compile
+     * the declarations only once
+     */
+    template <typename T> class Reloadable {
+        struct Version {
+            template <typename... Ts> explicit Version(Ts&&... ts) : args(std::forward<Ts>(ts)...) {}
+            std::vector<std::string> tokens;    // the commandline of a reload, the values are views into it
+            T args;
+        };
+
+        struct alignas(64) ReadIndicator {      // on its own cache line, as all readers update it
+            std::atomic<uint64_t> n{0};
+        };
+
+    public:
+        // The version of the options at the time of `read()`, which stays valid (and unchanged) until the Reader is destroyed
+        class Reader {
+        public:
+            Reader(Reader &&other) noexcept : readers(std::exchange(other.readers, nullptr)), args(other.args) {}
+            Reader(const Reader &) = delete;
+            Reader &operator=(const Reader &) = delete;
+            ~Reader() {
+                if (readers != nullptr)
+                    readers->fetch_sub(1);
+            }
+
+            const T &operator*() const { return *args; }
+            const T *operator->() const { return args; }
+
+        private:
+            Reader(std::atomic<uint64_t> *readers, const T *args) : readers(readers), args(args) {}
+
+            std::atomic<uint64_t> *readers;
+            const T *args;
+
+            friend class Reloadable;
+        };
+
+        // The first parse, which reports errors (or the help) like `argparse::parse`
+        Reloadable(int argc, const char* const *argv, const bool &raise_on_error = false) : commandline(argv, argv + argc) {
+            if constexpr (std::is_constructible<T, std::shared_ptr<const Schema>>::value)
+                schema = compile<T>();
+            std::unique_ptr<Version> first = _make_version();
+            std::vector<const char*> tokens;
+            for (const std::string &token : commandline)
+                tokens.emplace_back(token.c_str());
+            first->args.parse(int(tokens.size()), tokens.data(), raise_on_error);
+            origin = std::move(first);
+            current.store(origin.get());
+        }
+
+        Reloadable(const Reloadable &) = delete;
+        Reloadable &operator=(const Reloadable &) = delete;
+
+        ~Reloadable() {
+#ifndef _WIN32
+            stop_reload_on_signal();
+#endif
+            if (current.load() != origin.get())
+                delete current.load();
+        }
+
+        // Lock-free access to the current version, e.g. `options.read()->workers`
+        Reader read() const {
+            const int i = index.load();
+            readers[i].n.fetch_add(1);
+            return Reader(&readers[i].n, &current.load()->args);
+        }
+
+        // The number of reloads that have been published
+        [[nodiscard]] uint64_t version() const {
+            return n_versions.load();
+        }
+
+        /* Parse the first commandline again, which reads the environment and the configuration file anew. Returns the error message (of the
+         * first declared entry that failed) and keeps the current version, or an empty string when the new version is published
+         */
+        std::string reload() {
+            return _reload({});
+        }
+
+        // Reload from a new commandline (including the program name), of which only the reloadable entries are used
+        std::string reload(int argc, const char* const *argv) {
+            return _reload(std::vector<std::string>(argv, argv + argc));
+        }
+
+#ifndef _WIN32
+        /* Reload on each `signal` (e.g. `kill -HUP <pid>`), where the signal handler only wakes up a thread that does the reload.
+         * `on_reload` (if any) is called on that thread with the result of each reload. Only one Reloadable can reload on a signal at a time
+         */
+        void reload_on_signal(int signal = SIGHUP, std::function<void(const std::string &error)> on_reload = nullptr) {
+            int fds[2], expected = -1;
+            if (watcher.joinable() || ::pipe(fds) != 0)
+                throw std::logic_error("argparse: could not reload on signal " + std::to_string(signal));
+            if (!reload_signal_fd.compare_exchange_strong(expected, fds[1])) {
+                ::close(fds[0]);
+                ::close(fds[1]);
+                throw std::logic_error("argparse: another Reloadable already reloads on a signal");
+            }
+            signal_pipe = {fds[0], fds[1]};
+            watched_signal = signal;
+            struct sigaction action{};
+            action.sa_handler = on_reload_signal;
+            sigemptyset(&action.sa_mask);
+            action.sa_flags = SA_RESTART;
+            sigaction(signal, &action, &previous_action);
+            watcher = std::thread([this, on_reload = std::move(on_reload)]() {
+                char c = 0;
+                while (::read(signal_pipe[0], &c, 1) == 1 && c == 1) {
+                    const std::string error = reload();
+                    if (on_reload)
+                        on_reload(error);
+                }
+            });
+        }
+
+        void stop_reload_on_signal() {
+            if (!watcher.joinable())
+                return;
+            sigaction(watched_signal, &previous_action, nullptr);
+            reload_signal_fd.store(-1);
+            const char stop = 0;
+            (void)!::write(signal_pipe[1], &stop, 1);
+            watcher.join();
+            ::close(signal_pipe[0]);
+            ::close(signal_pipe[1]);
+        }
+#endif
+
+    private:
+        std::unique_ptr<Version> _make_version(std::vector<std::string> tokens = {}) const {
+            std::unique_ptr<Version> version;
+            if constexpr (std::is_constructible<T, std::shared_ptr<const Schema>>::value)
+                version = std::make_unique<Version>(schema);
+            else
+                version = std::make_unique<Version>();
+            version->tokens = std::move(tokens);
+            return version;
+        }
+
+        std::string _reload(std::vector<std::string> tokens) {
+            std::lock_guard<std::mutex> lock(reload_mutex);     // only serializes the reloads, readers never take it
+            std::unique_ptr<Version> next = _make_version(std::move(tokens));
+            std::vector<const char*> argv;
+            for (const std::string &token : next->tokens.empty()? commandline : next->tokens)
+                argv.emplace_back(token.c_str());
+            next->args.check(int(argv.size()), argv.data());
+            next->args._inherit(origin->args);
+            const auto &errors = next->args.errors();
+            if (!errors.empty())
+                return next->args.format_error(*std::min_element(errors.begin(), errors.end(), [](const auto &a, const auto &b) { return a.entry < b.entry; }));
+
+            Version *previous = current.exchange(next.release());
+            n_versions.fetch_add(1);
+            _wait_for_readers();
+            if (previous != origin.get())
+                delete previous;
+            return {};
+        }
+
+        /* Wait until no reader can refer to the previous version (the Left-Right algorithm): readers count themselves on the indicator
+         * that `index` pointed to when they arrived, which is flipped once the other indicator is empty, after which the old one drains
+         */
+        void _wait_for_readers() {
+            const int previous_index = index.load(), next_index = previous_index ^ 1;
+            while (readers[next_index].n.load() != 0)
+                std::this_thread::yield();
+            index.store(next_index);
+            while (readers[previous_index].n.load() != 0)
+                std::this_thread::yield();
+        }
+
+        std::vector<std::string> commandline;   // of the first parse
+        std::shared_ptr<const Schema> schema;
+        std::unique_ptr<Version> origin;        // the first version, which the values that are not reloaded are taken from
+        std::atomic<Version*> current{nullptr};
+        std::atomic<int> index{0};
+        mutable std::array<ReadIndicator, 2> readers;
+        std::atomic<uint64_t> n_versions{0};
+        std::mutex reload_mutex;
+#ifndef _WIN32
+        std::thread watcher;
+        std::array<int, 2> signal_pipe = {-1, -1};
+        int watched_signal = 0;
+        struct sigaction previous_action{};
+#endif
+    };
+}
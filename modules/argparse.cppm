@@ -0,0 +1,34 @@
+/* @author: Morris Franken
+ * C++20 module interface of argparse, to be used as `import argparse;` (see the `argparse_module` CMake target)
+ */
+module;
+#include "argparse/argparse.hpp"
+#include "argparse/batch.hpp"
+#include "argparse/reloadable.hpp"
+
+export module argparse;
+
+export namespace argparse {
+    using argparse::Args;
+    using argparse::Entry;
+    using argparse::Schema;
+    using argparse::ParseStats;
+    using argparse::ErrorKind;
+    using argparse::ParseError;
+    using argparse::BatchResult;
+    using argparse::validate_batch;
+    using argparse::Reloadable;
+    using argparse::format_error;
+    using argparse::parse;
+    using argparse::compile;
+    using argparse::from_string;
+    using argparse::get;
+    using argparse::range_list;
+    using argparse::StaticSchema;
+    using argparse::Field;
+    using argparse::make_schema;
+    using argparse::arg;
+    using argparse::kwarg;
+    using argparse::flag;
+    using argparse::completion_script;
+}
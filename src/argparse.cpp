@@ -0,0 +1,6 @@
+/* @author: Morris Franken
+ * Compiled-library mode of argparse (see ARGPARSE_COMPILED_LIBRARY in argparse.hpp), which compiles the parser and the conversions of
+ * common types once, such that translation units including the header only need their declarations.
+ */
+#define ARGPARSE_INSTANTIATE
+#include "argparse/argparse.hpp"
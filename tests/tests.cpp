@@ -5,12 +5,44 @@
  */
 #undef NDEBUG
 #include <iostream>
+#include <atomic>
 #include <cassert>
+#include <fstream>
+#include <memory_resource>
+#include <new>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "argparse/argparse.hpp"
+#include "argparse/batch.hpp"
+#include "argparse/reloadable.hpp"
 
 using namespace std;
 
+// Count all allocations on the global heap, to verify that a parse with a memory resource does not use it
+static std::atomic<size_t> global_allocations{0};     // also counts the allocations of the threads of validate_batch
+static void *allocate(size_t size) noexcept {
+    global_allocations++;
+    return std::malloc(size == 0? 1 : size);
+}
+[[gnu::noinline]] static void deallocate(void *p) noexcept { std::free(p); }   // not inlined into the delete operators, otherwise GCC reports a mismatch with `operator new`
+
+// all scalar, array, sized and nothrow forms are replaced, such that every pointer is released by the matching replacement
+void *operator new(size_t size) {
+    if (void *p = allocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+void *operator new[](size_t size) { return operator new(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return allocate(size); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return allocate(size); }
+void operator delete(void *p) noexcept { deallocate(p); }
+void operator delete[](void *p) noexcept { deallocate(p); }
+void operator delete(void *p, size_t) noexcept { deallocate(p); }
+void operator delete[](void *p, size_t) noexcept { deallocate(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { deallocate(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { deallocate(p); }
+
 struct Custom {
     std::string message;
 
@@ -83,6 +115,544 @@ void TEST_MULTI2() {
     }
 }
 
+void TEST_REPEATED() {
+    struct Args : public argparse::Args {
+        std::vector<std::string> &files   = arg("Files").multi_argument();
+        std::vector<std::string> &include = kwarg("I,include", "Include paths, may be repeated");
+        std::vector<int> &numbers         = kwarg("n,numbers", "Numbers, may be repeated");
+        std::vector<std::string> &extra   = kwarg("extra", "Extra files").multi_argument();
+    };
+
+    {
+        Args args = test_args<Args>("argparse_test a,1 b -I x -n 1,2 --include=y --extra e,1 e2 -n 3 --extra e3");
+
+        assert(args.files.size() == 2 && args.files[0] == "a,1" && args.files[1] == "b");   // multi-arguments are not split on ','
+        assert(args.include.size() == 2 && args.include[0] == "x" && args.include[1] == "y");
+        assert(args.numbers.size() == 3 && args.numbers[2] == 3);
+        assert(args.extra.size() == 3 && args.extra[0] == "e,1" && args.extra[2] == "e3");
+    }
+}
+
+void TEST_NUMBERS() {
+    struct Args : public argparse::Args {
+        long long &ll    = kwarg("ll", "A long long");
+        uint64_t &u64    = kwarg("u64", "An uint64");
+        int8_t &i8       = kwarg("i8", "An int8");
+        short &s         = kwarg("s", "A short").set_default(1);
+        double &d        = kwarg("d", "A double").set_default("2.5f");
+        std::vector<unsigned> &v = kwarg("v", "Unsigned values");
+    };
+
+    {
+        Args args = test_args<Args>("argparse_test --ll -9000000000 --u64 +18446744073709551615 --i8 -128 -v 1,2,3");
+
+        assert(args.ll == -9000000000LL);
+        assert(args.u64 == 18446744073709551615ULL);
+        assert(args.i8 == -128);
+        assert(args.s == 1);
+        assert(args.d == 2.5);
+        assert(args.v.size() == 3 && args.v[2] == 3);
+    }
+
+    auto expect_error = [](std::string command, const std::string &error) {
+        const auto &[argc, argv] = get_argc_argv(command);
+        try {
+            argparse::parse<Args>(argc, argv, true);
+            assert(false);
+        } catch (const std::runtime_error &e) {
+            assert(e.what() == error);
+        }
+    };
+    expect_error("argparse_test --ll 1 --u64 1 --i8 1 -s=40000 -v 1", "Invalid argument \"40000\" for -s (A short). Error: out of range");
+    expect_error("argparse_test --ll 1 --u64 1 --i8 1 -v 1,-2", "Invalid argument, could not convert \"-2\" at offset 2 of \"1,-2\" for -v (Unsigned values)");
+    expect_error("argparse_test --ll 1 --u64 1 --i8 1 -v 1 -d 1.5x", "Invalid argument, could not convert \"1.5x\" for -d (A double)");
+
+    int i = 0;
+    assert(argparse::from_string("12a", i) == std::errc::invalid_argument);
+    assert(argparse::from_string("3000000000", i) == std::errc::result_out_of_range);
+    assert(argparse::from_string(" 42", i) == std::errc() && i == 42);
+}
+
+void TEST_NUMBER_LISTS() {
+    struct Args : public argparse::Args {
+        std::vector<int> &ints          = kwarg("i,ints", "Integers").set_default("");
+        std::vector<int64_t> &longs     = kwarg("l,longs", "Long integers").set_default("");
+        std::vector<uint16_t> &shorts   = kwarg("s,shorts", "Unsigned shorts").set_default("");
+        std::vector<double> &doubles    = kwarg("d,doubles", "Doubles").set_default("");
+    };
+
+    // the delimiters are found in blocks, check lists that do not fit a single block and commas at the block boundaries
+    for (const size_t length : {1, 15, 16, 17, 31, 32, 33, 100}) {
+        std::string list;
+        for (size_t n = 0; n < length; n++)
+            list.push_back(n % 3 == 2 || n % 16 == 15? ',' : '1');
+        assert(argparse::count_commas(list.data(), list.data() + list.size()) == size_t(std::count(list.begin(), list.end(), ',')));
+        assert(argparse::find_comma(list.data(), list.data() + list.size()) - list.data() == std::ptrdiff_t(std::min(list.find(','), list.size())));
+        if (length > 4)     // unaligned
+            assert(argparse::find_comma(list.data() + 3, list.data() + length - 1) - list.data() == std::ptrdiff_t(std::min(list.find(',', 3), length - 1)));
+    }
+
+    std::string ints;
+    for (int n = -500; n < 500; n++)
+        ints.append(ints.empty()? "" : ",").append(std::to_string(n * 1001));
+    const std::string longs = "9223372036854775807,-9223372036854775808,+7,0";
+    Args args = test_args<Args>("argparse_test -i " + ints + ", -l=" + longs + " -s 65535,0 -d 1.5,-2e3,.25f");
+    assert(args.ints.size() == 1000 && args.ints.front() == -500500 && args.ints[500] == 0 && args.ints.back() == 499499);
+    assert(args.longs == std::vector<int64_t>({INT64_MAX, INT64_MIN, 7, 0}));
+    assert(args.shorts == std::vector<uint16_t>({65535, 0}));
+    assert(args.doubles == std::vector<double>({1.5, -2000, 0.25}));
+
+    // the first bad element is reported by its offset in the value
+    const char *argv[] = {"argparse_test", "-i", "1,2,,3", "-s=1,65536", "--longs", "-", "--doubles", "0.5,x"};
+    Args checked;
+    const auto &errors = checked.check(8, argv);
+    assert(errors.size() == 4);
+    assert(errors[0].kind == argparse::ErrorKind::INVALID_VALUE && errors[0].offset == 4);
+    assert(errors[1].kind == argparse::ErrorKind::OUT_OF_RANGE && errors[1].offset == 2);
+    assert(errors[2].kind == argparse::ErrorKind::INVALID_VALUE && errors[2].offset == 0);
+    assert(checked.format_error(errors[0]) == "Invalid argument, could not convert \"\" at offset 4 of \"1,2,,3\" for -i,--ints (Integers)");
+    assert(checked.format_error(errors[1]) == "Invalid argument \"65536\" at offset 2 of \"1,65536\" for -s,--shorts (Unsigned shorts). Error: out of range");
+    assert(checked.format_error(errors[2]) == "Invalid argument, could not convert \"-\" for -l,--longs (Long integers)");
+    assert(checked.format_error(errors[3]) == "Invalid argument, could not convert \"x\" at offset 4 of \"0.5,x\" for -d,--doubles (Doubles)");
+    assert(checked.ints == std::vector<int>({1, 2}));   // the elements before the bad one are kept
+}
+
+void TEST_RANGE_LIST() {
+    using argparse::range_list;
+    struct Args : public argparse::Args {
+        range_list<int> &gpus           = kwarg("g,gpus", "GPU selection").set_default("0-3");
+        range_list<int64_t> &offsets    = kwarg("o,offsets", "Offsets").set_default(range_list<int64_t>{{-8, -5}, {10, 10}});
+        range_list<uint32_t> &shards    = arg("Shards").multi_argument();
+    };
+
+    {
+        Args args = test_args<Args>("argparse_test 7 1-3 4-6 20 -g 0-1023,2048-4095,5000");
+        assert(args.gpus.ranges().size() == 3 && args.gpus.size() == 3073);
+        assert(args.gpus.contains(0) && args.gpus.contains(1023) && !args.gpus.contains(1024) && args.gpus.contains(5000) && !args.gpus.contains(-1));
+        assert(args.shards == range_list<uint32_t>({{1, 7}, {20, 20}}));     // merged with adjacent ranges
+        assert(args.offsets.size() == 5 && args.offsets.contains(-6) && !args.offsets.contains(-4));
+        assert(argparse::toString(args.offsets) == "-8--5,10");
+    }
+    {
+        Args args = test_args<Args>("argparse_test 1 -g 10-12,1-3 -g 5,4,13-14,-2--1");    // a repeated key adds to the ranges
+        assert(argparse::toString(args.gpus) == "-2--1,1-5,10-14");
+        assert(std::vector<int>(args.gpus.begin(), args.gpus.end()) == std::vector<int>({-2, -1, 1, 2, 3, 4, 5, 10, 11, 12, 13, 14}));
+        assert(args.gpus == argparse::get<range_list<int>>("-2--1,1-5,10-14"));
+    }
+
+    struct Options {
+        range_list<int> ids;
+    };
+    static constexpr auto schema = argparse::make_schema(argparse::arg(&Options::ids, "Ids").multi_argument());
+    const char *static_argv[] = {"argparse_test", "5-9", "1-3", "4"};
+    assert(schema.parse(4, static_argv, true).ids == range_list<int>({{1, 9}}));
+
+    range_list<unsigned char> bytes;
+    bytes.insert(250, 255);
+    bytes.insert(0, 249);
+    assert(bytes.ranges().size() == 1 && bytes.size() == 256 && std::distance(bytes.begin(), bytes.end()) == 256);
+
+    const char *argv[] = {"argparse_test", "1", "--gpus", "0-3,5-x", "-o", "3-1"};
+    Args args;
+    const auto &errors = args.check(6, argv);
+    assert(errors.size() == 2 && errors[0].offset == 4 && errors[1].offset == 0);
+    assert(args.format_error(errors[0]) == "Invalid argument, could not convert \"5-x\" at offset 4 of \"0-3,5-x\" for -g,--gpus (GPU selection)");
+    assert(args.format_error(errors[1]) == "Invalid argument, could not convert \"3-1\" for -o,--offsets (Offsets)");
+}
+
+struct Formatted {
+    static inline int n_formatted = 0;
+    int value = 0;
+    Formatted() = default;
+    explicit Formatted(int v) : value(v) {}
+    explicit Formatted(const std::string &v) : value(std::stoi(v)) {}
+    friend std::ostream &operator<<(std::ostream &os, const Formatted &f) {
+        n_formatted++;
+        return os << "#" << f.value;
+    }
+};
+
+void TEST_DEFAULTS() {
+    struct Args : public argparse::Args {
+        Formatted &f        = kwarg("f", "A typed default").set_default(Formatted(7));
+        float &alpha        = kwarg("a,alpha", "A default of another type").set_default(0.25);
+        std::string &name   = kwarg("name", "A default string").set_default("me");
+    };
+
+    {   // typed defaults are only formatted when they are shown
+        Formatted::n_formatted = 0;
+        Args args = test_args<Args>("argparse_test --name you");
+        assert(args.f.value == 7 && args.alpha == 0.25f && args.name == "you");
+        assert(Formatted::n_formatted == 1);    // by print() in test_args
+
+        const char *argv[] = {"argparse_test"};
+        Formatted::n_formatted = 0;
+        Args quiet;
+        quiet.parse(1, argv, true);
+        assert(quiet.f.value == 7 && Formatted::n_formatted == 0);
+    }
+    {   // help and print are written at once
+        std::ostringstream out;
+        std::streambuf *buffer = std::cout.rdbuf(out.rdbuf());
+        const char *argv[] = {"argparse_test", "-a", "0.5"};
+        Args args;
+        args.parse(3, argv, true);
+        args.print();
+        args.help();
+        std::cout.rdbuf(buffer);
+        const std::string text = out.str();
+        assert(text.find("                   -f : #7\n") != std::string::npos);
+        assert(text.find("               -f : A typed default [default: #7]\n") != std::string::npos);
+        assert(text.find("       -a,--alpha : A default of another type [default: 0.25]\n") != std::string::npos);
+        assert(text.find("           --name : A default string [default: me]\n") != std::string::npos);
+    }
+}
+
+void TEST_RESPONSE_FILE() {
+    struct Args : public argparse::Args {
+        std::vector<std::string> &files = arg("Files").multi_argument();
+        std::string &name               = kwarg("name", "A name");
+        int &k                          = kwarg("k", "An int");
+        bool &verbose                   = flag("v,verbose", "A flag to toggle verbose");
+    };
+
+    std::ofstream("argparse_test_nested.rsp") << "-k 3\n--verbose";
+    std::ofstream("argparse_test.rsp") << "  --name \"hello world\"\t'a \"b\"' c\\ d\r\n@argparse_test_nested.rsp \"@not_expanded\" ''";
+
+    {
+        Args args = test_args<Args>("argparse_test first @argparse_test.rsp @does_not_exist.rsp");
+
+        assert(args.name == "hello world");
+        assert(args.k == 3);
+        assert(args.verbose);
+        assert(args.files.size() == 6);
+        assert(args.files[0] == "first" && args.files[1] == "a \"b\"" && args.files[2] == "c d");
+        assert(args.files[3] == "@not_expanded" && args.files[4].empty() && args.files[5] == "@does_not_exist.rsp");
+    }
+    std::remove("argparse_test.rsp");
+    std::remove("argparse_test_nested.rsp");
+}
+
+void TEST_KEY_INDEX() {
+    std::map<std::string, int, std::less<>> entries;
+    for (int i = 0; i < 1000; i++)
+        entries["key_" + std::to_string(i)] = i;
+    entries["k"] = -1;
+
+    argparse::KeyIndex<int> index;
+    index.build(entries);
+    for (const auto &[key, value] : entries)
+        assert(index.find(key) != nullptr && *index.find(key) == value);
+    assert(index.find("key_1000") == nullptr);
+    assert(index.find("x") == nullptr);
+    assert(index.find("") == nullptr);
+
+    const std::map<std::string_view, int, std::less<>> similar = {{"color", 0}, {"color3", 1}, {"colors", 2}, {"help", 3}};    // only differ in the last character
+    index.build(similar);
+    for (const auto &[key, value] : similar)
+        assert(index.find(key) != nullptr && *index.find(key) == value);
+}
+
+void TEST_STRING_POOL() {
+    argparse::StringPool pool(std::pmr::get_default_resource());
+    const std::string_view a = pool.intern("a help text");
+    const std::string long_text(10000, 'x');
+    const std::string_view b = pool.intern(long_text);   // larger than a block
+    const std::string_view c = pool.intern(std::string("a help text"));
+
+    assert(a == "a help text" && b == long_text);
+    assert(a.data() == c.data());    // equal strings are stored once
+}
+
+void TEST_MEMORY_RESOURCE() {
+    struct Args : public argparse::Args {
+        using argparse::Args::Args;
+        std::string_view &src           = arg("A positional argument with a help text that does not fit in a small string");
+        std::pmr::string &dst           = arg("A positional argument with a default value").set_default("a default destination that does not fit in a small string");
+        int &k                          = kwarg("k,key", "A keyworded integer value").set_default(3);
+        float &alpha                    = kwarg("a,alpha", "An optional float value").set_default("0.5");
+        std::pmr::vector<int> &numbers  = kwarg("n,numbers", "An int vector");
+        std::pmr::vector<std::string_view> &files = kwarg("files", "multiple arguments").multi_argument();
+        bool &verbose                   = flag("v,verbose", "A flag to toggle verbose");
+    };
+
+    std::array<std::byte, 32 * 1024> buffer;
+    std::pmr::monotonic_buffer_resource resource(buffer.data(), buffer.size(), std::pmr::null_memory_resource());   // throws instead of falling back to the heap
+    const char *argv[] = {"argparse_test", "source", "-k", "5", "--numbers=1,2,3", "--files", "f1", "f2", "f3", "-v", "--alpha", "0.25"};
+
+    const size_t allocations_before = global_allocations;
+    {
+        auto args = argparse::parse<Args>(12, argv, &resource);
+        assert(global_allocations == allocations_before);
+
+        assert(args.src == "source" && args.dst.size() > 15 && args.k == 5 && args.alpha == 0.25f && args.verbose);
+        assert(args.numbers.size() == 3 && args.numbers[2] == 3);
+        assert(args.files.size() == 3 && args.files[2] == "f3");
+    }
+    assert(global_allocations == allocations_before);
+}
+
+void TEST_SCHEMA() {
+    struct Args : public argparse::Args {
+        using argparse::Args::Args;
+        std::string_view &src           = arg("Source");
+        int &k                          = kwarg("k,key", "A keyworded integer value").set_default(3);
+        std::vector<int> &numbers       = kwarg("n,numbers", "An int vector").set_default("1");
+        std::optional<float> &alpha     = kwarg("a,alpha", "An optional float value");
+        bool &verbose                   = flag("v,verbose", "A flag to toggle verbose");
+    };
+
+    {   // parsing the same object repeatedly starts from a clean state each time
+        Args args;
+        const char *argv1[] = {"argparse_test", "first", "-k", "5", "-n", "4,5,6", "-a", "0.5", "-v"};
+        args.parse(9, argv1, true);
+        assert(args.src == "first" && args.k == 5 && args.numbers.size() == 3 && args.alpha == 0.5f && args.verbose);
+
+        const char *argv2[] = {"argparse_test", "second", "-n", "7"};
+        args.parse(4, argv2, true);
+        assert(args.src == "second" && args.k == 3 && args.numbers.size() == 1 && args.numbers[0] == 7 && !args.alpha && !args.verbose);
+    }
+
+    {   // objects bound to a compiled schema only allocate their values
+        const auto schema = argparse::compile<Args>();
+        Args a(schema), b(schema);
+        const char *argv_a[] = {"argparse_test", "a", "--key=1"};
+        const char *argv_b[] = {"argparse_test", "b", "--numbers", "8,9"};
+        a.parse(3, argv_a, true);
+        b.parse(4, argv_b, true);
+        assert(a.src == "a" && a.k == 1 && a.numbers.size() == 1 && a.numbers[0] == 1);
+        assert(b.src == "b" && b.k == 3 && b.numbers.size() == 2 && b.numbers[1] == 9);
+    }
+
+    {   // a schema can only be used by the declarations it was compiled from
+        struct Other : public argparse::Args {
+            using argparse::Args::Args;
+            int &k = kwarg("k,key", "A keyworded integer value");
+        };
+        try {
+            Other other(argparse::compile<Args>());
+            assert(false);
+        } catch (const std::logic_error &e) {
+        }
+    }
+}
+
+void TEST_STATIC_SCHEMA() {
+    struct Options {
+        std::string_view src;
+        std::vector<std::string_view> files;
+        int k = 0;
+        float alpha = 0;
+        std::vector<int> numbers;
+        std::optional<std::string> name;
+        bool verbose = false;
+        bool quiet = false;
+    };
+
+    static constexpr auto schema = argparse::make_schema(
+            argparse::arg(&Options::src, "Source"),
+            argparse::arg(&Options::files, "Files").multi_argument().set_default(""),
+            argparse::kwarg(&Options::k, "k,key", "A required integer value"),
+            argparse::kwarg(&Options::alpha, "a,alpha", "An optional float value").set_default("0.5"),
+            argparse::kwarg(&Options::numbers, "n,numbers", "An int vector").set_default("1,2"),
+            argparse::kwarg(&Options::name, "name", "An optional string"),
+            argparse::flag(&Options::verbose, "v,verbose", "A flag to toggle verbose"),
+            argparse::flag(&Options::quiet, "q,quiet", "A flag to toggle quiet"));
+
+    {
+        const char *argv[] = {"argparse_test", "source", "f1", "f2", "-vq", "--key=5", "-n", "3", "-n", "4,5", "--name", "me"};
+        const Options o = schema.parse(12, argv, true);
+        assert(o.src == "source" && o.files.size() == 2 && o.files[1] == "f2");
+        assert(o.k == 5 && o.alpha == 0.5f && o.verbose && o.quiet && o.name == "me");
+        assert(o.numbers.size() == 3 && o.numbers[0] == 3 && o.numbers[2] == 5);
+    }
+    {
+        const char *argv[] = {"argparse_test", "source", "-k", "-3"};
+        const Options o = schema.parse(4, argv, true);
+        assert(o.src == "source" && o.files.empty() && o.k == -3 && !o.verbose && !o.name && o.numbers.size() == 2);
+    }
+    try {
+        const char *argv[] = {"argparse_test", "source"};
+        schema.parse(2, argv, true);
+        assert(false);
+    } catch (const std::runtime_error &e) {
+        assert(std::string(e.what()) == "Argument missing: -k,--key (A required integer value)");
+    }
+    try {
+        const char *argv[] = {"argparse_test", "source", "-k", "x"};
+        schema.parse(4, argv, true);
+        assert(false);
+    } catch (const std::runtime_error &e) {
+        assert(std::string(e.what()) == "Invalid argument, could not convert \"x\" for -k,--key (A required integer value)");
+    }
+}
+
+void TEST_COMPLETION() {
+    struct Args : public argparse::Args {
+        std::string &src    = arg("Source");
+        int &k              = kwarg("k,key", "An integer value").set_default(3);
+        bool &verbose       = flag("v,verbose", "A flag to toggle verbose");
+        bool &version       = flag("version", "Print the version");
+    };
+
+    Args args;
+    auto complete = [&](std::initializer_list<std::string_view> words) { return args.complete(words.begin(), words.size()); };
+    assert(complete({"--verb"}) == "--verbose\n");                 // unambiguous abbreviation
+    assert(complete({"--ver"}) == "--verbose\n--version\n");
+    assert(complete({"src", "--"}) == "--help\n--key\n--verbose\n--version\n");
+    assert(complete({"-"}) == "-k\n-v\n--help\n--key\n--verbose\n--version\n");
+    assert(complete({"--key", ""}).empty());                         // a value, which is left to the shell
+    assert(complete({"--unknown"}).empty());
+
+    argparse::PrefixTrie trie;
+    for (const std::string_view key : {"abc", "ab", "b", "abd"})
+        trie.insert(key);
+    std::string keys;
+    trie.complete("ab", [&](std::string_view key) { keys.append(key).append(" "); });
+    assert(keys == "ab abc abd ");
+
+    assert(argparse::completion_script("bash", "my-tool").find("complete -o default -F _argparse_complete_my_tool my-tool") != std::string::npos);
+    assert(argparse::completion_script("tcsh", "my-tool").empty());
+}
+
+void TEST_ENV() {
+    struct Args : public argparse::Args {
+        int &k                      = kwarg("k,key", "An integer value").env("ARGPARSE_TEST_KEY").set_default(3);
+        std::vector<int> &numbers   = kwarg("n,numbers", "An int vector").env("ARGPARSE_TEST_NUMBERS").set_default("1");
+        std::string &name           = kwarg("name", "A required string").env("ARGPARSE_TEST_NAME");
+    };
+
+    setenv("ARGPARSE_TEST_KEY", "7", 1);
+    setenv("ARGPARSE_TEST_NUMBERS", "4,5,6", 1);
+    setenv("ARGPARSE_TEST_NAME", "from env", 1);
+    {   // commandline > environment > default
+        Args args = test_args<Args>("argparse_test -k 5");
+        assert(args.k == 5 && args.numbers.size() == 3 && args.numbers[2] == 6 && args.name == "from env");
+    }
+    unsetenv("ARGPARSE_TEST_KEY");
+    unsetenv("ARGPARSE_TEST_NUMBERS");
+    {
+        Args args = test_args<Args>("argparse_test");
+        assert(args.k == 3 && args.numbers.size() == 1 && args.name == "from env");
+    }
+    setenv("ARGPARSE_TEST_KEY", "x", 1);
+    try {
+        const char *argv[] = {"argparse_test"};
+        argparse::parse<Args>(1, argv, true);
+        assert(false);
+    } catch (const std::runtime_error &e) {
+        assert(std::string(e.what()) == "Invalid argument, could not convert \"x\" for -k,--key (An integer value)");
+    }
+    unsetenv("ARGPARSE_TEST_KEY");
+    unsetenv("ARGPARSE_TEST_NAME");
+}
+
+void TEST_CONFIG_FILE() {
+    struct Args : public argparse::Args {
+        std::string &config         = kwarg("c,config", "Configuration file").config_file().set_default("argparse_test_default.ini");
+        int &k                      = kwarg("k,key", "An integer value").set_default(3);
+        std::vector<int> &numbers   = kwarg("n,numbers", "An int vector").set_default("1");
+        std::string &name           = kwarg("name", "A string").env("ARGPARSE_TEST_CONFIG_NAME").set_default("default");
+        std::string &host           = kwarg("server.host", "A key within a section").set_default("localhost");
+        bool &verbose               = flag("v,verbose", "A flag to toggle verbose");
+    };
+
+    std::ofstream("argparse_test.ini") << "# comment\nkey = 7\n; another comment\nnumbers=4,5\nnumbers = 6\nname = \"from config\"\nverbose = true\n\n[server]\nhost = example.com\r\n";
+    setenv("ARGPARSE_TEST_CONFIG_NAME", "from env", 1);
+    {   // commandline > environment > configuration file > default
+        Args args = test_args<Args>("argparse_test --config argparse_test.ini -k 5");
+        assert(args.k == 5 && args.name == "from env" && args.host == "example.com" && args.verbose);
+        assert(args.numbers.size() == 3 && args.numbers[0] == 4 && args.numbers[2] == 6);
+    }
+    unsetenv("ARGPARSE_TEST_CONFIG_NAME");
+    {   // a missing default configuration file is ignored
+        Args args = test_args<Args>("argparse_test");
+        assert(args.k == 3 && args.name == "default" && args.host == "localhost" && !args.verbose);
+    }
+    try {
+        const char *argv[] = {"argparse_test", "--config", "does_not_exist.ini"};
+        argparse::parse<Args>(3, argv, true);
+        assert(false);
+    } catch (const std::runtime_error &e) {
+        assert(std::string(e.what()) == "Could not read configuration file \"does_not_exist.ini\" for -c,--config (Configuration file)");
+    }
+    {   // check() records unrecognised keys instead of printing them
+        std::ofstream("argparse_test.ini") << "key = 7\ntypo = 1\n";
+        Args args;
+        const char *argv[] = {"argparse_test", "--config", "argparse_test.ini", "--unknown"};
+        const auto &errors = args.check(4, argv);
+        assert(errors.size() == 2 && errors[0].kind == argparse::ErrorKind::UNRECOGNISED_KEY && errors[0].token == 2);
+        assert(args.format_error(errors[0]) == "unrecognised commandline argument: unknown");
+        assert(args.format_error(errors[1]) == "unrecognised key in configuration file argparse_test.ini: typo" && args.k == 7);
+    }
+    std::remove("argparse_test.ini");
+}
+
+void TEST_CHECKS() {
+    struct Args : public argparse::Args {
+        std::vector<std::string_view> &inputs   = kwarg("i,inputs", "Input files").multi_argument().must_exist().readable();
+        std::vector<std::string> &extra         = kwarg("e,extra", "More input files").must_exist().set_default("");
+        std::string &output                     = kwarg("o,output", "Output directory").writable_dir().set_default(".");
+        std::string &name                       = kwarg("n,name", "A name").satisfies([](std::string_view v) { return v.find('/') == std::string_view::npos; }, "contains a '/'").set_default("out");
+    };
+    using argparse::ErrorKind;
+
+    std::ofstream("argparse_test_input.txt") << "input";
+    {
+        Args args = test_args<Args>("argparse_test -i argparse_test_input.txt argparse_test_input.txt -e argparse_test_input.txt");
+        assert(args.inputs.size() == 2 && args.output == ".");
+    }
+    {   // defaults are checked as well
+        struct Defaults : public argparse::Args {
+            std::string &input                  = kwarg("i,input", "Input file").must_exist().set_default("missing_default.txt");
+            std::string &cache                  = kwarg("c,cache", "Cache directory").writable_dir().set_default(std::string("missing_directory"));
+            std::string &log                    = kwarg("l,log", "Optional log file").must_exist().set_default("");
+            std::vector<std::string> &includes  = kwarg("I,include", "Include files").must_exist().set_default(std::vector<std::string>{"argparse_test_input.txt"});
+            std::vector<std::string> &sources   = kwarg("s,sources", "Source files").must_exist().set_default(std::vector<std::string>{"argparse_test_input.txt", "missing_source.txt"});
+        };
+        Defaults args;
+        const char *argv[] = {"argparse_test"};
+        const auto &errors = args.check(1, argv);
+        assert(errors.size() == 3 && errors[0].kind == ErrorKind::FAILED_CHECK && errors[0].token == argparse::ParseError::no_token);
+        assert(args.format_error(errors[0]) == "Invalid argument \"missing_default.txt\" for -i,--input (Input file): does not exist");
+        assert(errors[1].entry == 1 && errors[1].value == "missing_directory");
+        assert(errors[2].entry == 4 && errors[2].value == "missing_source.txt");     // the elements of a typed default are checked
+        assert(args.includes.size() == 1 && argparse::toString(args.sources) == "argparse_test_input.txt,missing_source.txt");
+    }
+    {   // every failing value is reported, in order
+        Args args;
+        args.set_check_threads(4);
+        const char *argv[] = {"argparse_test", "-i", "argparse_test_input.txt", "missing_1.txt", "missing_2.txt", "-e", "argparse_test_input.txt,missing_3.txt", "-o", "argparse_test_input.txt", "-n", "a/b"};
+        const auto &errors = args.check(11, argv);
+        assert(errors.size() == 5);
+        assert(errors[0].entry == 0 && errors[0].kind == ErrorKind::FAILED_CHECK && errors[0].token == 2 && errors[0].value == "missing_1.txt");
+        assert(errors[1].entry == 0 && errors[1].token == 3 && errors[1].value == "missing_2.txt");
+        assert(errors[2].entry == 1 && errors[2].token == 5 && errors[2].offset == 24);
+        assert(args.format_error(errors[2]) == "Invalid argument \"missing_3.txt\" at offset 24 of \"argparse_test_input.txt,missing_3.txt\" for -e,--extra (More input files): does not exist");
+        assert(args.format_error(errors[3]) == "Invalid argument \"argparse_test_input.txt\" for -o,--output (Output directory): is not a writable directory");
+        assert(args.format_error(errors[4]) == "Invalid argument \"a/b\" for -n,--name (A name): contains a '/'");
+    }
+    {   // many values are checked concurrently
+        std::vector<std::string> files(200);
+        std::vector<const char*> argv = {"argparse_test", "-i"};
+        for (size_t i = 0; i < files.size(); i++)
+            argv.emplace_back((files[i] = i % 2? "argparse_test_input.txt" : "missing_" + std::to_string(i)).c_str());
+        Args args;
+        const auto &errors = args.check(int(argv.size()), argv.data());
+        assert(errors.size() == 100);
+        for (size_t i = 0; i < errors.size(); i++)
+            assert(errors[i].value == argv[i * 2 + 2] && errors[i].token == i * 2 + 1);
+    }
+    try {
+        const char *argv[] = {"argparse_test", "-i", "missing.txt", "-o", "."};
+        argparse::parse<Args>(5, argv, true);
+        assert(false);
+    } catch (const std::runtime_error &e) {
+        assert(std::string(e.what()) == "Invalid argument \"missing.txt\" for -i,--inputs (Input files): does not exist");
+    }
+    std::remove("argparse_test_input.txt");
+}
+
 #ifdef HAS_MAGIC_ENUM
 void TEST_ENUM() {
     enum Color {
@@ -95,6 +665,7 @@ void TEST_ENUM() {
         Color& color  = kwarg("c,color", "An Enum input");
         Color& color2 = kwarg("color2", "An Enum input").set_default(RED);
         Color& color3 = kwarg("color3", "An Enum input", "green");
+        std::vector<Color>& colors = kwarg("colors", "A vector of Enums").set_default("");
     };
 
     {
@@ -104,6 +675,23 @@ void TEST_ENUM() {
         assert(args.color2 == RED);
         assert(args.color3 == GREEN);
     }
+    {   // case-insensitive lookup of each element
+        Args args = test_args<Args>("argparse_test --color RED --color3 --colors green,Blue,rEd");
+        assert(args.colors.size() == 3 && args.colors[0] == GREEN && args.colors[1] == BLUE && args.colors[2] == RED);
+    }
+    try {
+        const char *argv[] = {"argparse_test", "--color", "purple", "--color3"};
+        argparse::parse<Args>(4, argv, true);
+        assert(false);
+    } catch (const std::runtime_error &e) {
+        assert(std::string(e.what()) == "Invalid argument \"purple\" for -c,--color (An Enum input). Error: enum is only accepting [red, blue, green]");
+    }
+    {   // completion of enum values
+        Args args;
+        const std::string_view words[] = {"--color", "b"}, equal[] = {"--color=G"};
+        assert(args.complete(words, 2) == "blue\n");
+        assert(args.complete(equal, 1) == "--color=green\n");
+    }
 }
 #endif
 
@@ -165,6 +753,331 @@ void TEST_ALL() {
     }
 }
 
+void TEST_STRING_VIEW() {
+    struct Args : public argparse::Args {
+        std::string_view &name  = kwarg("n,name", "A name, viewing directly into argv");
+        std::string_view &empty = arg("An empty positional");
+        bool &a                 = flag("a", "flag a");
+        bool &b                 = flag("b", "flag b");
+        int &c                  = kwarg("c", "A value at the end of a short cluster");
+    };
+
+    {
+        const char *argv[] = {"argparse_test", "--name=hello", "", "-abc=4"};
+        auto args = argparse::parse<Args>(4, argv);
+
+        assert(args.name == "hello" && args.name.data() == argv[1] + 7);   // no copy was made
+        assert(args.empty.empty());
+        assert(args.a && args.b && args.c == 4);
+    }
+}
+
+void TEST_STREAM() {
+    struct Args : public argparse::Args {
+        std::vector<int> &ids           = kwarg("i,ids", "Streamed integers").env("ARGPARSE_TEST_IDS").set_default("");
+        std::vector<double> &weights    = kwarg("w,weights", "Streamed doubles").set_default("");
+        std::string &output             = kwarg("o,output", "A plain value").set_default("out");
+    };
+
+    {   // more elements than fit in a single chunk, separated by commas, spaces and newlines
+        std::ofstream file("argparse_test_ids.txt");
+        for (int i = 0; i < 100000; i++)
+            file << i << (i % 10 == 9? "\n" : i % 2? " " : ",");
+    }
+    const int fd = open("argparse_test_ids.txt", O_RDONLY);
+    int pipe_fds[2];
+    assert(fd >= 0 && pipe(pipe_fds) == 0);
+    assert(write(pipe_fds[1], "0.5,1.5\n2.5", 11) == 11);
+    close(pipe_fds[1]);
+    {
+        const std::string ids = "@fd:" + std::to_string(fd), weights = "@fd:" + std::to_string(pipe_fds[0]);
+        const char *argv[] = {"argparse_test", "--ids", ids.c_str(), "-w", weights.c_str(), "-o", "-"};
+        Args args = argparse::parse<Args>(7, argv, true);
+        assert(args.ids.size() == 100000 && args.ids[12345] == 12345 && args.ids.back() == 99999);
+        assert(args.weights.size() == 3 && args.weights[2] == 2.5);
+        assert(args.output == "-");    // not a vector, therefore not streamed
+    }
+    close(fd);
+    close(pipe_fds[0]);
+
+    assert(pipe(pipe_fds) == 0);
+    assert(write(pipe_fds[1], "1,2,x,4", 7) == 7);
+    close(pipe_fds[1]);
+    try {
+        const std::string ids = "@fd:" + std::to_string(pipe_fds[0]);
+        const char *argv[] = {"argparse_test", "--ids", ids.c_str()};
+        argparse::parse<Args>(3, argv, true);
+        assert(false);
+    } catch (const std::runtime_error &e) {
+        assert(std::string(e.what()) == "Invalid argument, could not convert \"x\" for -i,--ids (Streamed integers)");
+    }
+    close(pipe_fds[0]);
+    std::remove("argparse_test_ids.txt");
+
+    setenv("ARGPARSE_TEST_IDS", "-", 1);
+    try {   // only values on the commandline are streamed, an environment variable of "-" is a plain value
+        const char *argv[] = {"argparse_test"};
+        argparse::parse<Args>(1, argv, true);
+        assert(false);
+    } catch (const std::runtime_error &e) {
+        assert(std::string(e.what()) == "Invalid argument, could not convert \"-\" for -i,--ids (Streamed integers)");
+    }
+    unsetenv("ARGPARSE_TEST_IDS");
+}
+
+void TEST_STATS() {
+    struct Args : public argparse::Args {
+        std::pmr::vector<int> &numbers  = kwarg("n,numbers", "An int vector");  // allocates from the parser's resource, and is therefore counted
+        int &k                          = kwarg("k,key", "An integer value").set_default(3);
+        bool &verbose                   = flag("v,verbose", "A flag to toggle verbose");
+    };
+
+    const char *argv[] = {"argparse_test", "-n", "1,2,3,4,5,6,7,8", "--verbose"};
+    {
+        Args args;
+        args.parse(4, argv, true);
+        assert(!args.stats().enabled && args.stats().phases[argparse::ParseStats::CONVERT].ns == 0);
+    }
+
+    Args args;
+    args.collect_stats();
+    args.parse(4, argv, true);
+    const argparse::ParseStats &stats = args.stats();
+    assert(stats.enabled && args.numbers.size() == 8);
+    assert(stats.phases[argparse::ParseStats::TOKENIZE].allocations > 0);      // the tokens
+    assert(stats.phases[argparse::ParseStats::CONVERT].allocations > 0);       // the elements of the vector
+    assert(stats.entries[0].ns > 0 && stats.entries[0].bytes >= 8 * sizeof(int));
+    assert(stats.entries[1].ns == 0);    // the default of -k is copied, not converted
+
+    const std::string report = args.stats_report(1);
+    assert(report.find("key lookup :") != std::string::npos && report.find("-n,--numbers :") != std::string::npos);
+    assert(report.find("-v,--verbose :") == std::string::npos);   // only the slowest entry
+
+    args.parse(4, argv, true);     // the capacity of the previous parse is reused
+    assert(stats.phases[argparse::ParseStats::TOKENIZE].allocations == 0);
+
+    args.collect_stats(false);
+    setenv("ARGPARSE_STATS", "1", 1);     // also dumps the report to stderr
+    args.parse(4, argv, true);
+    assert(args.stats().enabled);
+    unsetenv("ARGPARSE_STATS");
+}
+
+void TEST_BATCH() {
+    struct Args : public argparse::Args {
+        using argparse::Args::Args;
+        int &k                      = kwarg("k,key", "An integer value");
+        std::vector<int> &numbers   = kwarg("n,numbers", "An int vector").set_default("");
+        bool &verbose               = flag("v,verbose", "A flag to toggle verbose");
+    };
+    using argparse::ErrorKind, argparse::ParseError;
+
+    {   // all errors are collected, instead of only the first
+        Args args;
+        const char *argv[] = {"argparse_test", "--numbers", "1,x", "-v", "--key"};
+        const auto &errors = args.check(5, argv);
+        assert(errors.size() == 3);
+        assert(errors[0].entry == 1 && errors[0].kind == ErrorKind::INVALID_VALUE && errors[0].token == 1 && errors[0].value == "1,x" && errors[0].offset == 2);
+        assert(errors[1].entry == 0 && errors[1].kind == ErrorKind::MISSING_VALUE && errors[1].token == 3);
+        assert(errors[2].entry == 0 && errors[2].kind == ErrorKind::MISSING_ARGUMENT);
+        assert(args.format_error(errors[1]) == "No value provided for: key");
+    }
+
+    std::vector<std::vector<std::string>> commandlines;
+    for (int i = 0; i < 1000; i++) {
+        switch (i % 4) {
+            case 0: commandlines.push_back({"argparse_test", "-k", std::to_string(i), "-n", "1,2,3"}); break;
+            case 1: commandlines.push_back({"argparse_test", "-v"}); break;
+            case 2: commandlines.push_back({"argparse_test", "--help", "-k", "99999999999", "--numbers=1,2,x"}); break;   // help is not printed
+            case 3: commandlines.push_back({"argparse_test", "-k=1", "--verbose", "--numbers", "4"}); break;
+        }
+    }
+    const argparse::BatchResult result = argparse::validate_batch<Args>(commandlines, 4);
+    for (size_t i = 0; i < commandlines.size(); i++) {
+        const std::vector<ParseError> &errors = result.errors[i];
+        switch (i % 4) {
+            case 1:
+                assert(errors.size() == 1 && errors[0].kind == ErrorKind::MISSING_ARGUMENT && errors[0].token == ParseError::no_token);
+                assert(result.format_error(errors[0]) == "Argument missing: -k,--key (An integer value)");
+                break;
+            case 2:
+                assert(errors.size() == 2 && errors[0].kind == ErrorKind::OUT_OF_RANGE && errors[0].token == 2);
+                assert(errors[1].kind == ErrorKind::INVALID_VALUE && errors[1].token == 3 && errors[1].value == "1,2,x" && errors[1].offset == 4);
+                assert(result.format_error(errors[0]) == "Invalid argument \"99999999999\" for -k,--key (An integer value). Error: out of range");
+                break;
+            default:
+                assert(errors.empty());
+        }
+    }
+}
+
+void TEST_SNAPSHOT() {
+    struct Args : public argparse::Args {
+        std::string_view &src               = arg("Source path");
+        std::vector<std::string> &files     = arg("Files").multi_argument();
+        int &k                              = kwarg("k,key", "An integer value").set_default(3);
+        std::vector<double> &weights        = kwarg("w,weights", "A double vector");
+        std::optional<int> &optional        = kwarg("o,optional", "An optional int");
+        Custom &custom                      = kwarg("c,custom", "A custom class, converted again").set_default("default");
+        std::vector<int> &repeated          = kwarg("r,repeated", "A repeated vector").set_default("");
+        bool &verbose                       = flag("v,verbose", "A flag to toggle verbose");
+    };
+    struct OtherArgs : public argparse::Args {
+        int &k = kwarg("k,key", "An integer value").set_default(3);
+    };
+
+    {
+        const char *argv[] = {"argparse_test", "source", "a", "b", "-w", "0.5,1.5", "--custom", "hello", "-r", "1,2", "-r", "3", "--verbose", "-k", "7"};
+        Args args;
+        args.parse(15, argv, true);
+        assert(args.save_snapshot("argparse_test.snapshot"));
+    }
+    {
+        Args args;
+        args.load_snapshot("argparse_test.snapshot");
+        assert(args.src == "source" && args.files.size() == 2 && args.files[1] == "b" && args.k == 7);
+        assert(args.weights.size() == 2 && args.weights[1] == 1.5 && !args.optional.has_value());
+        assert(args.custom.message == "hello" && args.verbose);
+        assert(args.repeated.size() == 3 && args.repeated[2] == 3);
+        args.print();
+    }
+    try {
+        OtherArgs args;
+        args.load_snapshot("argparse_test.snapshot");
+        assert(false);
+    } catch (const std::runtime_error &e) {
+        assert(std::string(e.what()) == "Invalid snapshot \"argparse_test.snapshot\": written by other declarations");
+    }
+    std::remove("argparse_test.snapshot");
+}
+
+void TEST_RELOAD() {
+    struct Args : public argparse::Args {
+        using argparse::Args::Args;
+        std::string_view &name  = kwarg("name", "Not reloadable");
+        int &workers            = kwarg("w,workers", "Reloadable").set_default(4).reloadable();
+        int &port               = kwarg("p,port", "Reloadable from the environment").env("ARGPARSE_TEST_PORT").set_default(80).reloadable();
+        std::string &config     = kwarg("config", "Configuration file").config_file().set_default("");
+        std::vector<int> &ids   = kwarg("ids", "Reloadable from the configuration file").set_default("").reloadable();
+    };
+    std::ofstream("argparse_test_reload.ini") << "ids = 1,2\n";
+    const char *argv[] = {"argparse_test", "--name", "service", "--config", "argparse_test_reload.ini"};
+    argparse::Reloadable<Args> options(5, argv, true);
+    assert(options.read()->name == "service" && options.read()->workers == 4 && options.read()->port == 80 && options.read()->ids.size() == 2);
+
+    // the environment and configuration file are read anew
+    setenv("ARGPARSE_TEST_PORT", "8080", 1);
+    std::ofstream("argparse_test_reload.ini") << "ids = 3,4,5\nname = other\n";
+    assert(options.reload().empty() && options.version() == 1);
+    assert(options.read()->port == 8080 && options.read()->ids.size() == 3 && options.read()->name == "service");
+
+    {   // entries that are not reloadable keep their values, and do not need to be given again
+        const char *next[] = {"argparse_test", "--workers", "8", "--name", "ignored"};
+        assert(options.reload(5, next).empty());
+        const auto args = options.read();
+        assert(args->workers == 8 && args->name == "service" && args->port == 8080 && args->ids.empty());
+        const char *invalid[] = {"argparse_test", "--workers", "x"};
+        assert(options.reload(3, invalid) == "Invalid argument, could not convert \"x\" for -w,--workers (Reloadable)");
+        assert(args->workers == 8 && options.read()->workers == 8 && options.version() == 2);
+    }
+    unsetenv("ARGPARSE_TEST_PORT");
+
+    {   // readers on other threads always see a complete version, where workers == port
+        const char *equal[] = {"argparse_test", "-w", "1", "-p", "1"};
+        assert(options.reload(5, equal).empty());
+        std::atomic<bool> done{false};
+        std::atomic<uint64_t> n_reads{0};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; t++) {
+            readers.emplace_back([&]() {
+                while (!done) {
+                    const auto args = options.read();
+                    assert(args->workers == args->port && args->name == "service");
+                    n_reads++;
+                }
+            });
+        }
+        int i = 0;
+        for (; i < 200 || n_reads < 1000; i++) {
+            const std::string value = std::to_string(i);
+            const char *next[] = {"argparse_test", "-w", value.c_str(), "-p", value.c_str()};
+            assert(options.reload(5, next).empty());
+        }
+        done = true;
+        for (std::thread &thread : readers)
+            thread.join();
+        assert(options.read()->workers == i - 1);
+    }
+
+    {   // reload on SIGHUP
+        std::atomic<int> n_reloads{0};
+        options.reload_on_signal(SIGHUP, [&](const std::string &error) { assert(error.empty()); n_reloads++; });
+        setenv("ARGPARSE_TEST_PORT", "9090", 1);
+        raise(SIGHUP);
+        for (int i = 0; i < 1000 && n_reloads == 0; i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        options.stop_reload_on_signal();
+        assert(n_reloads == 1 && options.read()->port == 9090);
+        unsetenv("ARGPARSE_TEST_PORT");
+    }
+    std::remove("argparse_test_reload.ini");
+}
+
+void TEST_SUBCOMMANDS() {
+    static int n_constructed = 0;
+    struct Commit : public argparse::Args {
+        std::string &message        = kwarg("m,message", "The commit message");
+        bool &all                   = flag("a,all", "Stage all files");
+        Commit() { n_constructed++; }
+    };
+    struct Push : public argparse::Args {
+        std::string &remote         = arg("The remote").set_default("origin");
+        bool &force                 = flag("f,force", "Force the push");
+        Push() { n_constructed++; }
+    };
+    struct Args : public argparse::Args {
+        bool &verbose                   = flag("v,verbose", "A global flag");
+        std::shared_ptr<Commit> &commit = subcommand<Commit>("commit", "Record changes");
+        std::shared_ptr<Push> &push     = subcommand<Push>("push", "Update the remote");
+    };
+
+    {   // only the selected subcommand is constructed, the global options before it are parsed by the parent
+        Args args = test_args<Args>("argparse_test -v commit -am message");
+        assert(args.verbose && args.commit && !args.push && n_constructed == 1);
+        assert(args.commit->all && args.commit->message == "message");
+    }
+    {
+        Args args = test_args<Args>("argparse_test push upstream --force");
+        assert(!args.verbose && !args.commit && args.push && n_constructed == 2);
+        assert(args.push->remote == "upstream" && args.push->force);
+    }
+    {
+        Args args = test_args<Args>("argparse_test");
+        assert(!args.commit && !args.push && n_constructed == 2);
+        assert(args.complete(nullptr, 0) == "commit\npush\n");
+    }
+    try {
+        const char *argv[] = {"argparse_test", "pull"};
+        argparse::parse<Args>(2, argv, true);
+        assert(false);
+    } catch (const std::runtime_error &e) {
+        assert(std::string(e.what()) == "Unknown command: pull");
+    }
+
+    struct Tool : public argparse::Args {   // a parent with its own positional arguments
+        std::vector<std::string> &files     = arg("Input files").multi_argument().set_default("");
+        std::shared_ptr<Push> &push          = subcommand<Push>("push", "Update the remote");
+    };
+    {   // a later positional argument that matches a subcommand is not a command
+        Tool tool = test_args<Tool>("argparse_test input.txt push");
+        assert(!tool.push && tool.files.size() == 2 && tool.files[1] == "push");
+    }
+    {
+        Tool tool = test_args<Tool>("argparse_test push upstream");
+        assert(tool.push && tool.push->remote == "upstream" && tool.files.empty());
+    }
+}
+
 void TEST_THROW() {
     struct Args : public argparse::Args {
         std::string &A = arg("Source path");
@@ -196,6 +1109,28 @@ int main(int argc, char* argv[]) {
     TEST_ALL();
     TEST_MULTI();
     TEST_MULTI2();
+    TEST_STRING_VIEW();
+    TEST_REPEATED();
+    TEST_NUMBERS();
+    TEST_NUMBER_LISTS();
+    TEST_RANGE_LIST();
+    TEST_DEFAULTS();
+    TEST_RESPONSE_FILE();
+    TEST_KEY_INDEX();
+    TEST_STRING_POOL();
+    TEST_MEMORY_RESOURCE();
+    TEST_SCHEMA();
+    TEST_STATIC_SCHEMA();
+    TEST_COMPLETION();
+    TEST_ENV();
+    TEST_CONFIG_FILE();
+    TEST_CHECKS();
+    TEST_STREAM();
+    TEST_SUBCOMMANDS();
+    TEST_STATS();
+    TEST_BATCH();
+    TEST_RELOAD();
+    TEST_SNAPSHOT();
     TEST_THROW();
 #ifdef HAS_MAGIC_ENUM
     TEST_ENUM();